@@ -53,9 +53,9 @@ namespace Cascade_Core
         }
     }
 
-    std::shared_ptr<Window> Application::Create_Window(std::string window_title, uint32_t width, uint32_t height)
+    std::shared_ptr<Window> Application::Create_Window(std::string window_title, uint32_t width, uint32_t height, Cascade_Graphics::Vulkan_Backend::Swapchain_Wrapper::Present_Policy present_policy, double target_frame_rate)
     {
-        m_window_ptrs.push_back(std::make_shared<Window>(window_title, width, height, m_graphics));
+        m_window_ptrs.push_back(std::make_shared<Window>(window_title, width, height, m_graphics, present_policy, target_frame_rate));
 
         Wait_For_Window_Initialization();
 
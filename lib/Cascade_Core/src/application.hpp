@@ -36,7 +36,11 @@ namespace Cascade_Core
         ~Application();
 
     public:
-        std::shared_ptr<Window> Create_Window(std::string window_title, uint32_t width, uint32_t height);
+        std::shared_ptr<Window> Create_Window(std::string window_title,
+                                             uint32_t width,
+                                             uint32_t height,
+                                             Cascade_Graphics::Vulkan_Backend::Swapchain_Wrapper::Present_Policy present_policy = Cascade_Graphics::Vulkan_Backend::Swapchain_Wrapper::Present_Policy::UNCAPPED,
+                                             double target_frame_rate = 0.0);
 
         void Wait_For_Windows_To_Exit();
         void Run_Program_Loop(std::function<void(Application*)> function_to_run, uint32_t repetitions_per_second);
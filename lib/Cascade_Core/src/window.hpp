@@ -37,6 +37,8 @@ namespace Cascade_Core
         std::string m_window_title;
         uint32_t m_width;
         uint32_t m_height;
+        Cascade_Graphics::Vulkan_Backend::Swapchain_Wrapper::Present_Policy m_present_policy;
+        double m_target_frame_rate;
 
         std::shared_ptr<Event_Manager> m_event_manager_ptr;
 
@@ -76,7 +78,12 @@ namespace Cascade_Core
         static void Render_Loop(Window* window_ptr);
 
     public:
-        Window(std::string window_title, uint32_t width, uint32_t height, std::shared_ptr<Cascade_Graphics::Vulkan_Backend::Vulkan_Graphics> graphics_ptr);
+        Window(std::string window_title,
+               uint32_t width,
+               uint32_t height,
+               std::shared_ptr<Cascade_Graphics::Vulkan_Backend::Vulkan_Graphics> graphics_ptr,
+               Cascade_Graphics::Vulkan_Backend::Swapchain_Wrapper::Present_Policy present_policy,
+               double target_frame_rate);
 
     public:
         void Close_Window();
@@ -62,6 +62,49 @@ namespace Cascade_Graphics
             LOG_TRACE << "Vulkan Backend: Finished allocating command buffer";
         }
 
+        void Command_Buffer_Manager::Bind_Pipeline(uint32_t command_buffer_index)
+        {
+            LOG_TRACE << "Vulkan Backend: Binding pipeline";
+
+            switch (m_pipeline_manager_ptr->Get_Pipeline_Data(m_command_buffers[command_buffer_index].pipeline_identifier)->type)
+            {
+                case Pipeline_Manager::Pipeline_Type::COMPUTE:
+                {
+                    vkCmdBindPipeline(m_command_buffers[command_buffer_index].command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline_manager_ptr->Get_Pipeline_Data(m_command_buffers[command_buffer_index].pipeline_identifier)->pipeline);
+                    break;
+                }
+                default:
+                {
+                    LOG_ERROR << "Vulkan Backend: Unknown pipeline type";
+                    exit(EXIT_FAILURE);
+                }
+            }
+
+            LOG_TRACE << "Vulkan Backend: Binding descriptor set";
+
+            switch (m_pipeline_manager_ptr->Get_Pipeline_Data(m_command_buffers[command_buffer_index].pipeline_identifier)->type)
+            {
+                case Pipeline_Manager::Pipeline_Type::COMPUTE:
+                {
+                    for (uint32_t i = 0; i < m_command_buffers[command_buffer_index].resource_group_identifiers.size(); i++)
+                    {
+                        if (m_storage_manager_ptr->Get_Resource_Grouping(m_command_buffers[command_buffer_index].resource_group_identifiers[i])->has_descriptor_set)
+                        {
+                            vkCmdBindDescriptorSets(m_command_buffers[command_buffer_index].command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                                                    m_pipeline_manager_ptr->Get_Pipeline_Data(m_command_buffers[command_buffer_index].pipeline_identifier)->pipeline_layout, 0, 1,
+                                                    &m_descriptor_set_manager->Get_Descriptor_Set_Data(m_command_buffers[command_buffer_index].resource_group_identifiers[i])->descriptor_set, 0, nullptr);
+                        }
+                    }
+                    break;
+                }
+                default:
+                {
+                    LOG_ERROR << "Vulkan Backend: Unknown pipeline type";
+                    exit(EXIT_FAILURE);
+                }
+            }
+        }
+
         uint32_t Command_Buffer_Manager::Get_Command_Buffer_Index(Identifier identifier)
         {
             for (uint32_t i = 0; i < m_command_buffers.size(); i++)
@@ -186,46 +229,18 @@ namespace Cascade_Graphics
 
             if (!(m_command_buffers[command_buffer_index].pipeline_identifier.label == "" && m_command_buffers[command_buffer_index].pipeline_identifier.index == 0))
             {
-                LOG_TRACE << "Vulkan Backend: Binding pipeline";
+                Bind_Pipeline(command_buffer_index);
+            }
+        }
 
-                switch (m_pipeline_manager_ptr->Get_Pipeline_Data(m_command_buffers[command_buffer_index].pipeline_identifier)->type)
-                {
-                    case Pipeline_Manager::Pipeline_Type::COMPUTE:
-                    {
-                        vkCmdBindPipeline(m_command_buffers[command_buffer_index].command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline_manager_ptr->Get_Pipeline_Data(m_command_buffers[command_buffer_index].pipeline_identifier)->pipeline);
-                        break;
-                    }
-                    default:
-                    {
-                        LOG_ERROR << "Vulkan Backend: Unknown pipeline type";
-                        exit(EXIT_FAILURE);
-                    }
-                }
+        void Command_Buffer_Manager::Bind_Compute_Pipeline(Identifier identifier, Identifier pipeline_identifier)
+        {
+            LOG_TRACE << "Vulkan Backend: Switching pipeline in command buffer " << identifier.Get_Identifier_String();
 
-                LOG_TRACE << "Vulkan Backend: Binding descriptor set";
+            uint32_t command_buffer_index = Get_Command_Buffer_Index(identifier);
 
-                switch (m_pipeline_manager_ptr->Get_Pipeline_Data(m_command_buffers[command_buffer_index].pipeline_identifier)->type)
-                {
-                    case Pipeline_Manager::Pipeline_Type::COMPUTE:
-                    {
-                        for (uint32_t i = 0; i < m_command_buffers[command_buffer_index].resource_group_identifiers.size(); i++)
-                        {
-                            if (m_storage_manager_ptr->Get_Resource_Grouping(m_command_buffers[command_buffer_index].resource_group_identifiers[i])->has_descriptor_set)
-                            {
-                                vkCmdBindDescriptorSets(m_command_buffers[command_buffer_index].command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-                                                        m_pipeline_manager_ptr->Get_Pipeline_Data(m_command_buffers[command_buffer_index].pipeline_identifier)->pipeline_layout, 0, 1,
-                                                        &m_descriptor_set_manager->Get_Descriptor_Set_Data(m_command_buffers[command_buffer_index].resource_group_identifiers[i])->descriptor_set, 0, nullptr);
-                            }
-                        }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG_ERROR << "Vulkan Backend: Unknown pipeline type";
-                        exit(EXIT_FAILURE);
-                    }
-                }
-            }
+            m_command_buffers[command_buffer_index].pipeline_identifier = pipeline_identifier;
+            Bind_Pipeline(command_buffer_index);
         }
 
         void Command_Buffer_Manager::End_Recording(Identifier identifier)
@@ -237,6 +252,27 @@ namespace Cascade_Graphics
             vkEndCommandBuffer(m_command_buffers[command_buffer_index].command_buffer);
         }
 
+        void Command_Buffer_Manager::Set_Image_Initial_Usage(Identifier identifier, Identifier resource_identifier, VkAccessFlags access_flags, VkPipelineStageFlags pipeline_stage_flags)
+        {
+            LOG_TRACE << "Vulkan Backend: Setting initial usage of image " << resource_identifier.Get_Identifier_String() << " in command buffer " << identifier.Get_Identifier_String();
+
+            uint32_t command_buffer_index = Get_Command_Buffer_Index(identifier);
+
+            // The layout stays undefined, only the first barrier's source scope changes so it waits for work from earlier submissions
+            for (uint32_t i = 0; i < m_command_buffers[command_buffer_index].image_resource_states.size(); i++)
+            {
+                if (m_command_buffers[command_buffer_index].image_resource_states[i].identifier == resource_identifier)
+                {
+                    m_command_buffers[command_buffer_index].image_resource_states[i].current_access_flags = access_flags;
+                    m_command_buffers[command_buffer_index].image_resource_states[i].current_pipeline_stage_flags = pipeline_stage_flags;
+                    return;
+                }
+            }
+
+            LOG_ERROR << "Vulkan Backend: No image resources with the identifier " << resource_identifier.Get_Identifier_String() << " exists in provided resource groupings";
+            exit(EXIT_FAILURE);
+        }
+
         void Command_Buffer_Manager::Image_Memory_Barrier(Identifier identifier, Identifier resource_identifier, VkAccessFlags access_flags, VkImageLayout image_layout, VkPipelineStageFlags pipeline_stage_flags)
         {
             LOG_TRACE << "Vulkan Backend: Image memory barrier in command buffer " << identifier.Get_Identifier_String();
@@ -286,6 +322,45 @@ namespace Cascade_Graphics
                                  m_command_buffers[command_buffer_index].image_resource_states[resource_index].current_pipeline_stage_flags, 0, 0, nullptr, 0, nullptr, 1, &image_memory_barrier);
         }
 
+        void Command_Buffer_Manager::Memory_Barrier(Identifier identifier, VkAccessFlags source_access_flags, VkAccessFlags destination_access_flags, VkPipelineStageFlags source_stage_flags, VkPipelineStageFlags destination_stage_flags)
+        {
+            LOG_TRACE << "Vulkan Backend: Memory barrier in command buffer " << identifier.Get_Identifier_String();
+
+            VkMemoryBarrier memory_barrier = {};
+            memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            memory_barrier.pNext = nullptr;
+            memory_barrier.srcAccessMask = source_access_flags;
+            memory_barrier.dstAccessMask = destination_access_flags;
+
+            vkCmdPipelineBarrier(m_command_buffers[Get_Command_Buffer_Index(identifier)].command_buffer, source_stage_flags, destination_stage_flags, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+        }
+
+        void Command_Buffer_Manager::Buffer_Memory_Barrier(Identifier identifier,
+                                                           Identifier resource_identifier,
+                                                           VkAccessFlags source_access_flags,
+                                                           VkAccessFlags destination_access_flags,
+                                                           VkPipelineStageFlags source_stage_flags,
+                                                           VkPipelineStageFlags destination_stage_flags,
+                                                           uint32_t source_queue_family,
+                                                           uint32_t destination_queue_family)
+        {
+            LOG_TRACE << "Vulkan Backend: Buffer memory barrier for " << resource_identifier.Get_Identifier_String() << " in command buffer " << identifier.Get_Identifier_String();
+
+            // Differing queue families make this one half of a queue family ownership transfer
+            VkBufferMemoryBarrier buffer_memory_barrier = {};
+            buffer_memory_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            buffer_memory_barrier.pNext = nullptr;
+            buffer_memory_barrier.srcAccessMask = source_access_flags;
+            buffer_memory_barrier.dstAccessMask = destination_access_flags;
+            buffer_memory_barrier.srcQueueFamilyIndex = source_queue_family;
+            buffer_memory_barrier.dstQueueFamilyIndex = destination_queue_family;
+            buffer_memory_barrier.buffer = m_storage_manager_ptr->Get_Buffer_Resource(resource_identifier)->buffer;
+            buffer_memory_barrier.offset = 0;
+            buffer_memory_barrier.size = VK_WHOLE_SIZE;
+
+            vkCmdPipelineBarrier(m_command_buffers[Get_Command_Buffer_Index(identifier)].command_buffer, source_stage_flags, destination_stage_flags, 0, 0, nullptr, 1, &buffer_memory_barrier, 0, nullptr);
+        }
+
         void Command_Buffer_Manager::Dispatch_Compute_Shader(Identifier identifier, uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
         {
             LOG_TRACE << "Vulkan Backend: Dispatching compute shader in command buffer " << identifier.Get_Identifier_String();
@@ -358,6 +433,41 @@ namespace Cascade_Graphics
                             1, &buffer_copy_data);
         }
 
+        void Command_Buffer_Manager::Update_Buffer(Identifier identifier, Identifier resource_identifier, const void* data, VkDeviceSize data_size, VkDeviceSize dst_offset)
+        {
+            LOG_TRACE << "Vulkan Backend: Updating buffer " << resource_identifier.Get_Identifier_String() << " in command buffer " << identifier.Get_Identifier_String();
+
+            // The data is recorded into the command buffer, so this is meant for small updates of device-local buffers
+            if (data_size > 65536 || data_size % 4 != 0)
+            {
+                LOG_ERROR << "Vulkan Backend: Buffer updates must be a multiple of 4 bytes and at most 65536 bytes, but " << data_size << " bytes were provided";
+                exit(EXIT_FAILURE);
+            }
+
+            vkCmdUpdateBuffer(m_command_buffers[Get_Command_Buffer_Index(identifier)].command_buffer, m_storage_manager_ptr->Get_Buffer_Resource(resource_identifier)->buffer, dst_offset, data_size, data);
+        }
+
+        void Command_Buffer_Manager::Fill_Buffer(Identifier identifier, Identifier resource_identifier, uint32_t data, VkDeviceSize fill_size, VkDeviceSize dst_offset)
+        {
+            LOG_TRACE << "Vulkan Backend: Filling buffer " << resource_identifier.Get_Identifier_String() << " in command buffer " << identifier.Get_Identifier_String();
+
+            vkCmdFillBuffer(m_command_buffers[Get_Command_Buffer_Index(identifier)].command_buffer, m_storage_manager_ptr->Get_Buffer_Resource(resource_identifier)->buffer, dst_offset, fill_size, data);
+        }
+
+        void Command_Buffer_Manager::Reset_Queries(Identifier identifier, VkQueryPool query_pool, uint32_t first_query, uint32_t query_count)
+        {
+            LOG_TRACE << "Vulkan Backend: Resetting queries in command buffer " << identifier.Get_Identifier_String();
+
+            vkCmdResetQueryPool(m_command_buffers[Get_Command_Buffer_Index(identifier)].command_buffer, query_pool, first_query, query_count);
+        }
+
+        void Command_Buffer_Manager::Write_Timestamp(Identifier identifier, VkQueryPool query_pool, VkPipelineStageFlagBits pipeline_stage, uint32_t query)
+        {
+            LOG_TRACE << "Vulkan Backend: Writing timestamp in command buffer " << identifier.Get_Identifier_String();
+
+            vkCmdWriteTimestamp(m_command_buffers[Get_Command_Buffer_Index(identifier)].command_buffer, pipeline_stage, query_pool, query);
+        }
+
         VkCommandBuffer* Command_Buffer_Manager::Get_Command_Buffer(Identifier identifier)
         {
             return &m_command_buffers[Get_Command_Buffer_Index(identifier)].command_buffer;
@@ -63,6 +63,7 @@ namespace Cascade_Graphics
         private:
             void Create_Command_Pool(uint32_t queue_family);
             void Allocate_Command_Buffer(uint32_t command_buffer_index, uint32_t command_pool_index);
+            void Bind_Pipeline(uint32_t command_buffer_index);
 
             uint32_t Get_Command_Buffer_Index(Identifier identifier);
             uint32_t Get_Next_Index(std::string label);
@@ -80,11 +81,26 @@ namespace Cascade_Graphics
             void Reset_Command_Buffer(Identifier identifier);
 
             void Begin_Recording(Identifier identifier, VkCommandBufferUsageFlagBits usage_flags);
+            void Bind_Compute_Pipeline(Identifier identifier, Identifier pipeline_identifier);
             void End_Recording(Identifier identifier);
+            void Set_Image_Initial_Usage(Identifier identifier, Identifier resource_identifier, VkAccessFlags access_flags, VkPipelineStageFlags pipeline_stage_flags);
             void Image_Memory_Barrier(Identifier identifier, Identifier resource_identifier, VkAccessFlags access_flags, VkImageLayout image_layout, VkPipelineStageFlags pipeline_stage_flags);
+            void Memory_Barrier(Identifier identifier, VkAccessFlags source_access_flags, VkAccessFlags destination_access_flags, VkPipelineStageFlags source_stage_flags, VkPipelineStageFlags destination_stage_flags);
+            void Buffer_Memory_Barrier(Identifier identifier,
+                                       Identifier resource_identifier,
+                                       VkAccessFlags source_access_flags,
+                                       VkAccessFlags destination_access_flags,
+                                       VkPipelineStageFlags source_stage_flags,
+                                       VkPipelineStageFlags destination_stage_flags,
+                                       uint32_t source_queue_family = VK_QUEUE_FAMILY_IGNORED,
+                                       uint32_t destination_queue_family = VK_QUEUE_FAMILY_IGNORED);
             void Dispatch_Compute_Shader(Identifier identifier, uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z);
             void Copy_Image(Identifier identifier, Identifier source_resource_identifier, Identifier destination_resource_identifier, uint32_t width, uint32_t height);
             void Copy_Buffer(Identifier identifier, Identifier source_resource_identifier, Identifier destination_resource_identifier, VkDeviceSize src_offset, VkDeviceSize dst_offset, VkDeviceSize copy_size);
+            void Update_Buffer(Identifier identifier, Identifier resource_identifier, const void* data, VkDeviceSize data_size, VkDeviceSize dst_offset = 0);
+            void Fill_Buffer(Identifier identifier, Identifier resource_identifier, uint32_t data, VkDeviceSize fill_size = VK_WHOLE_SIZE, VkDeviceSize dst_offset = 0);
+            void Reset_Queries(Identifier identifier, VkQueryPool query_pool, uint32_t first_query, uint32_t query_count);
+            void Write_Timestamp(Identifier identifier, VkQueryPool query_pool, VkPipelineStageFlagBits pipeline_stage, uint32_t query);
 
             VkCommandBuffer* Get_Command_Buffer(Identifier identifier);
         };
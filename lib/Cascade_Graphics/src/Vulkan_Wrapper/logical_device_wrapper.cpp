@@ -18,9 +18,15 @@ namespace Cascade_Graphics
             std::vector<const char*> required_extensions(required_extensions_set.begin(), required_extensions_set.end());
             std::vector<VkDeviceQueueCreateInfo> device_queue_create_infos = queue_manager_ptr->Generate_Device_Queue_Create_Infos(&queue_priority);
 
+            // Timeline semaphores let transfers and frames wait on each other without a fence per submission
+            VkPhysicalDeviceVulkan12Features vulkan_12_features = {};
+            vulkan_12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+            vulkan_12_features.pNext = nullptr;
+            vulkan_12_features.timelineSemaphore = VK_TRUE;
+
             VkDeviceCreateInfo device_create_info = {};
             device_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-            device_create_info.pNext = nullptr;
+            device_create_info.pNext = &vulkan_12_features;
             device_create_info.flags = 0;
             device_create_info.queueCreateInfoCount = static_cast<uint32_t>(device_queue_create_infos.size());
             device_create_info.pQueueCreateInfos = device_queue_create_infos.data();
@@ -0,0 +1,285 @@
+#include "memory_allocator.hpp"
+
+#include "debug_tools.hpp"
+#include <algorithm>
+
+
+namespace Cascade_Graphics
+{
+    namespace Vulkan_Backend
+    {
+        Memory_Allocator::Memory_Allocator(std::shared_ptr<Logical_Device_Wrapper> logical_device_wrapper_ptr, std::shared_ptr<Physical_Device_Wrapper> physical_device_wrapper_ptr, VkDeviceSize block_size)
+            : m_block_size(block_size), m_logical_device_wrapper_ptr(logical_device_wrapper_ptr)
+        {
+            VkPhysicalDeviceProperties physical_device_properties;
+            vkGetPhysicalDeviceProperties(*physical_device_wrapper_ptr->Get_Physical_Device(), &physical_device_properties);
+            vkGetPhysicalDeviceMemoryProperties(*physical_device_wrapper_ptr->Get_Physical_Device(), &m_memory_properties);
+
+            m_max_device_memory_count = physical_device_properties.limits.maxMemoryAllocationCount;
+        }
+
+        Memory_Allocator::~Memory_Allocator()
+        {
+            LOG_INFO << "Vulkan Backend: Freeing device memory";
+
+            for (uint32_t i = 0; i < m_memory_blocks.size(); i++)
+            {
+                if (m_memory_blocks[i].allocation_count != 0)
+                {
+                    LOG_WARN << "Vulkan Backend: Freeing memory block " << m_memory_blocks[i].block_id << " with " << m_memory_blocks[i].allocation_count << " allocations still in use";
+                }
+
+                Free_Device_Memory(m_memory_blocks[i].device_memory, m_memory_blocks[i].mapped_memory_ptr != nullptr);
+            }
+            m_memory_blocks.clear();
+
+            for (uint32_t i = 0; i < m_dedicated_allocations.size(); i++)
+            {
+                Free_Device_Memory(m_dedicated_allocations[i].device_memory, m_dedicated_allocations[i].mapped_memory_ptr != nullptr);
+            }
+            m_dedicated_allocations.clear();
+
+            LOG_TRACE << "Vulkan Backend: Finished freeing device memory";
+        }
+
+        VkDeviceMemory Memory_Allocator::Allocate_Device_Memory(VkDeviceSize size, uint32_t memory_type_index, void** mapped_memory_ptr_ptr)
+        {
+            if (m_device_memory_count >= m_max_device_memory_count)
+            {
+                LOG_ERROR << "Vulkan Backend: Allocating more device memory would exceed the device's limit of " << m_max_device_memory_count << " allocations";
+                exit(EXIT_FAILURE);
+            }
+
+            VkMemoryAllocateInfo memory_allocate_info = {};
+            memory_allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            memory_allocate_info.pNext = nullptr;
+            memory_allocate_info.allocationSize = size;
+            memory_allocate_info.memoryTypeIndex = memory_type_index;
+
+            VkDeviceMemory device_memory;
+            VALIDATE_VKRESULT(vkAllocateMemory(*m_logical_device_wrapper_ptr->Get_Device(), &memory_allocate_info, nullptr, &device_memory), "Vulkan Backend: Failed to allocate device memory");
+            m_device_memory_count++;
+
+            // Host-visible memory stays mapped for its whole lifetime, since a VkDeviceMemory can only be mapped once at a time and is now shared by several resources
+            *mapped_memory_ptr_ptr = nullptr;
+            if (m_memory_properties.memoryTypes[memory_type_index].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+            {
+                VALIDATE_VKRESULT(vkMapMemory(*m_logical_device_wrapper_ptr->Get_Device(), device_memory, 0, VK_WHOLE_SIZE, 0, mapped_memory_ptr_ptr), "Vulkan Backend: Failed to map memory");
+            }
+
+            return device_memory;
+        }
+
+        void Memory_Allocator::Free_Device_Memory(VkDeviceMemory device_memory, bool is_mapped)
+        {
+            if (is_mapped)
+            {
+                vkUnmapMemory(*m_logical_device_wrapper_ptr->Get_Device(), device_memory);
+            }
+
+            vkFreeMemory(*m_logical_device_wrapper_ptr->Get_Device(), device_memory, nullptr);
+            m_device_memory_count--;
+        }
+
+        bool Memory_Allocator::Suballocate(Memory_Block* memory_block_ptr, VkMemoryRequirements memory_requirements, Allocation* allocation_ptr)
+        {
+            // First fit, the free ranges are kept sorted by offset so neighbours can be merged when freed
+            for (uint32_t i = 0; i < memory_block_ptr->free_ranges.size(); i++)
+            {
+                Free_Range free_range = memory_block_ptr->free_ranges[i];
+
+                VkDeviceSize aligned_offset = (free_range.offset + memory_requirements.alignment - 1) / memory_requirements.alignment * memory_requirements.alignment;
+                if (aligned_offset + memory_requirements.size > free_range.offset + free_range.size)
+                {
+                    continue;
+                }
+
+                memory_block_ptr->free_ranges.erase(memory_block_ptr->free_ranges.begin() + i);
+
+                VkDeviceSize allocation_end = aligned_offset + memory_requirements.size;
+                if (allocation_end < free_range.offset + free_range.size)
+                {
+                    memory_block_ptr->free_ranges.insert(memory_block_ptr->free_ranges.begin() + i, {allocation_end, free_range.offset + free_range.size - allocation_end});
+                }
+                if (aligned_offset > free_range.offset)
+                {
+                    memory_block_ptr->free_ranges.insert(memory_block_ptr->free_ranges.begin() + i, {free_range.offset, aligned_offset - free_range.offset});
+                }
+
+                memory_block_ptr->allocation_count++;
+
+                *allocation_ptr = {};
+                allocation_ptr->device_memory = memory_block_ptr->device_memory;
+                allocation_ptr->offset = aligned_offset;
+                allocation_ptr->size = memory_requirements.size;
+                allocation_ptr->memory_type_index = memory_block_ptr->memory_type_index;
+                allocation_ptr->is_dedicated = false;
+                allocation_ptr->block_id = memory_block_ptr->block_id;
+                allocation_ptr->mapped_memory_ptr = (memory_block_ptr->mapped_memory_ptr == nullptr) ? nullptr : static_cast<uint8_t*>(memory_block_ptr->mapped_memory_ptr) + aligned_offset;
+
+                return true;
+            }
+
+            return false;
+        }
+
+        Memory_Allocator::Allocation Memory_Allocator::Allocate(VkMemoryRequirements memory_requirements, uint32_t memory_type_index, bool is_linear)
+        {
+            // Blocks are a fraction of their heap so small heaps aren't filled by a single block
+            VkDeviceSize heap_size = m_memory_properties.memoryHeaps[m_memory_properties.memoryTypes[memory_type_index].heapIndex].size;
+            VkDeviceSize block_size = std::min(m_block_size, heap_size / 8);
+
+            if (memory_requirements.size > block_size / 2)
+            {
+                LOG_TRACE << "Vulkan Backend: Creating dedicated allocation of " << memory_requirements.size << " bytes in memory type " << memory_type_index;
+
+                Allocation allocation = {};
+                allocation.offset = 0;
+                allocation.size = memory_requirements.size;
+                allocation.memory_type_index = memory_type_index;
+                allocation.is_dedicated = true;
+                allocation.block_id = 0;
+                allocation.device_memory = Allocate_Device_Memory(memory_requirements.size, memory_type_index, &allocation.mapped_memory_ptr);
+
+                m_dedicated_allocations.push_back(allocation);
+
+                return allocation;
+            }
+
+            // Buffers and optimally tiled images never share a block, so bufferImageGranularity never has to be considered
+            Allocation allocation = {};
+            for (uint32_t i = 0; i < m_memory_blocks.size(); i++)
+            {
+                if (m_memory_blocks[i].memory_type_index == memory_type_index && m_memory_blocks[i].is_linear == is_linear && Suballocate(&m_memory_blocks[i], memory_requirements, &allocation))
+                {
+                    return allocation;
+                }
+            }
+
+            LOG_DEBUG << "Vulkan Backend: Creating memory block " << m_next_block_id << " of " << block_size << " bytes in memory type " << memory_type_index;
+
+            m_memory_blocks.resize(m_memory_blocks.size() + 1);
+            m_memory_blocks.back() = {};
+            m_memory_blocks.back().block_id = m_next_block_id++;
+            m_memory_blocks.back().memory_type_index = memory_type_index;
+            m_memory_blocks.back().is_linear = is_linear;
+            m_memory_blocks.back().block_size = block_size;
+            m_memory_blocks.back().device_memory = Allocate_Device_Memory(block_size, memory_type_index, &m_memory_blocks.back().mapped_memory_ptr);
+            m_memory_blocks.back().free_ranges = {{0, block_size}};
+            m_memory_blocks.back().allocation_count = 0;
+
+            Suballocate(&m_memory_blocks.back(), memory_requirements, &allocation);
+
+            return allocation;
+        }
+
+        void Memory_Allocator::Free(Allocation allocation)
+        {
+            if (allocation.device_memory == VK_NULL_HANDLE)
+            {
+                return;
+            }
+
+            if (allocation.is_dedicated)
+            {
+                for (uint32_t i = 0; i < m_dedicated_allocations.size(); i++)
+                {
+                    if (m_dedicated_allocations[i].device_memory == allocation.device_memory)
+                    {
+                        Free_Device_Memory(allocation.device_memory, allocation.mapped_memory_ptr != nullptr);
+                        m_dedicated_allocations.erase(m_dedicated_allocations.begin() + i);
+                        return;
+                    }
+                }
+
+                LOG_ERROR << "Vulkan Backend: Tried to free a dedicated allocation which doesn't exist";
+                exit(EXIT_FAILURE);
+            }
+
+            for (uint32_t i = 0; i < m_memory_blocks.size(); i++)
+            {
+                if (m_memory_blocks[i].block_id != allocation.block_id)
+                {
+                    continue;
+                }
+
+                Memory_Block* memory_block_ptr = &m_memory_blocks[i];
+                std::vector<Free_Range>& free_ranges = memory_block_ptr->free_ranges;
+
+                uint32_t insert_index = 0;
+                while (insert_index < free_ranges.size() && free_ranges[insert_index].offset < allocation.offset)
+                {
+                    insert_index++;
+                }
+                free_ranges.insert(free_ranges.begin() + insert_index, {allocation.offset, allocation.size});
+
+                // Merge with the following and then the preceding range to keep fragmentation down
+                if (insert_index + 1 < free_ranges.size() && free_ranges[insert_index].offset + free_ranges[insert_index].size == free_ranges[insert_index + 1].offset)
+                {
+                    free_ranges[insert_index].size += free_ranges[insert_index + 1].size;
+                    free_ranges.erase(free_ranges.begin() + insert_index + 1);
+                }
+                if (insert_index > 0 && free_ranges[insert_index - 1].offset + free_ranges[insert_index - 1].size == free_ranges[insert_index].offset)
+                {
+                    free_ranges[insert_index - 1].size += free_ranges[insert_index].size;
+                    free_ranges.erase(free_ranges.begin() + insert_index);
+                }
+
+                memory_block_ptr->allocation_count--;
+
+                // Keep one empty block per memory type around so resizing a resource doesn't reallocate device memory every time
+                if (memory_block_ptr->allocation_count == 0)
+                {
+                    for (uint32_t j = 0; j < m_memory_blocks.size(); j++)
+                    {
+                        if (j != i && m_memory_blocks[j].memory_type_index == memory_block_ptr->memory_type_index && m_memory_blocks[j].is_linear == memory_block_ptr->is_linear && m_memory_blocks[j].allocation_count == 0)
+                        {
+                            LOG_DEBUG << "Vulkan Backend: Freeing empty memory block " << memory_block_ptr->block_id;
+
+                            Free_Device_Memory(memory_block_ptr->device_memory, memory_block_ptr->mapped_memory_ptr != nullptr);
+                            m_memory_blocks.erase(m_memory_blocks.begin() + i);
+                            break;
+                        }
+                    }
+                }
+
+                return;
+            }
+
+            LOG_ERROR << "Vulkan Backend: Tried to free an allocation from memory block " << allocation.block_id << " which doesn't exist";
+            exit(EXIT_FAILURE);
+        }
+
+        Memory_Allocator::Memory_Statistics Memory_Allocator::Get_Statistics()
+        {
+            Memory_Statistics memory_statistics = {};
+            memory_statistics.device_memory_count = m_device_memory_count;
+            memory_statistics.block_count = static_cast<uint32_t>(m_memory_blocks.size());
+            memory_statistics.dedicated_allocation_count = static_cast<uint32_t>(m_dedicated_allocations.size());
+
+            for (uint32_t i = 0; i < m_memory_blocks.size(); i++)
+            {
+                memory_statistics.suballocation_count += m_memory_blocks[i].allocation_count;
+                memory_statistics.allocated_size += m_memory_blocks[i].block_size;
+                memory_statistics.free_range_count += static_cast<uint32_t>(m_memory_blocks[i].free_ranges.size());
+
+                for (uint32_t j = 0; j < m_memory_blocks[i].free_ranges.size(); j++)
+                {
+                    memory_statistics.free_size += m_memory_blocks[i].free_ranges[j].size;
+                    memory_statistics.largest_free_range = std::max(memory_statistics.largest_free_range, m_memory_blocks[i].free_ranges[j].size);
+                }
+            }
+
+            for (uint32_t i = 0; i < m_dedicated_allocations.size(); i++)
+            {
+                memory_statistics.allocated_size += m_dedicated_allocations[i].size;
+            }
+
+            // Alignment padding is counted as used
+            memory_statistics.used_size = memory_statistics.allocated_size - memory_statistics.free_size;
+            memory_statistics.fragmentation = (memory_statistics.free_size == 0) ? 0.0 : 1.0 - static_cast<double>(memory_statistics.largest_free_range) / static_cast<double>(memory_statistics.free_size);
+
+            return memory_statistics;
+        }
+    } // namespace Vulkan_Backend
+} // namespace Cascade_Graphics
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "logical_device_wrapper.hpp"
+#include "physical_device_wrapper.hpp"
+#include "vulkan_header.hpp"
+#include <memory>
+#include <vector>
+
+
+namespace Cascade_Graphics
+{
+    namespace Vulkan_Backend
+    {
+        class Memory_Allocator
+        {
+        public:
+            struct Allocation
+            {
+                VkDeviceMemory device_memory;
+                VkDeviceSize offset;
+                VkDeviceSize size;
+                uint32_t memory_type_index;
+
+                bool is_dedicated;
+                uint32_t block_id;
+                void* mapped_memory_ptr;
+            };
+
+            struct Memory_Statistics
+            {
+                uint32_t device_memory_count;
+                uint32_t block_count;
+                uint32_t dedicated_allocation_count;
+                uint32_t suballocation_count;
+
+                VkDeviceSize allocated_size;
+                VkDeviceSize used_size;
+                VkDeviceSize free_size;
+                VkDeviceSize largest_free_range;
+                uint32_t free_range_count;
+                double fragmentation;
+            };
+
+        private:
+            struct Free_Range
+            {
+                VkDeviceSize offset;
+                VkDeviceSize size;
+            };
+
+            struct Memory_Block
+            {
+                uint32_t block_id;
+                uint32_t memory_type_index;
+                bool is_linear;
+
+                VkDeviceMemory device_memory;
+                VkDeviceSize block_size;
+                void* mapped_memory_ptr;
+
+                std::vector<Free_Range> free_ranges;
+                uint32_t allocation_count;
+            };
+
+        private:
+            VkDeviceSize m_block_size;
+            uint32_t m_next_block_id = 0;
+            uint32_t m_device_memory_count = 0;
+            uint32_t m_max_device_memory_count;
+            VkPhysicalDeviceMemoryProperties m_memory_properties;
+
+            std::vector<Memory_Block> m_memory_blocks;
+            std::vector<Allocation> m_dedicated_allocations;
+
+            std::shared_ptr<Logical_Device_Wrapper> m_logical_device_wrapper_ptr;
+
+        private:
+            VkDeviceMemory Allocate_Device_Memory(VkDeviceSize size, uint32_t memory_type_index, void** mapped_memory_ptr_ptr);
+            void Free_Device_Memory(VkDeviceMemory device_memory, bool is_mapped);
+            bool Suballocate(Memory_Block* memory_block_ptr, VkMemoryRequirements memory_requirements, Allocation* allocation_ptr);
+
+        public:
+            Memory_Allocator(std::shared_ptr<Logical_Device_Wrapper> logical_device_wrapper_ptr, std::shared_ptr<Physical_Device_Wrapper> physical_device_wrapper_ptr, VkDeviceSize block_size = 64 * 1024 * 1024);
+            ~Memory_Allocator();
+
+        public:
+            Allocation Allocate(VkMemoryRequirements memory_requirements, uint32_t memory_type_index, bool is_linear);
+            void Free(Allocation allocation);
+
+            Memory_Statistics Get_Statistics();
+        };
+    } // namespace Vulkan_Backend
+} // namespace Cascade_Graphics
\ No newline at end of file
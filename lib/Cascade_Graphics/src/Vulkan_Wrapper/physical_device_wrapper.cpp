@@ -84,6 +84,12 @@ namespace Cascade_Graphics
                 return false;
             }
 
+            if (!Check_Device_Feature_Support(physical_device, physical_device_properties))
+            {
+                LOG_INFO << "Vulkan Backend: Physical device '" << physical_device_properties.deviceName << "' is missing a required feature";
+                return false;
+            }
+
             LOG_INFO << "Vulkan Backend: Physical device '" << physical_device_properties.deviceName << "' has all required features";
             return true;
         }
@@ -137,6 +143,35 @@ namespace Cascade_Graphics
             return device_supports_extensions;
         }
 
+        bool Physical_Device_Wrapper::Check_Device_Feature_Support(VkPhysicalDevice physical_device, VkPhysicalDeviceProperties physical_device_properties)
+        {
+            LOG_TRACE << "Vulkan Backend: Checking physical device feature support";
+
+            if (physical_device_properties.apiVersion < VK_API_VERSION_1_2)
+            {
+                LOG_TRACE << "Vulkan Backend: This physical device doesn't support Vulkan 1.2";
+                return false;
+            }
+
+            VkPhysicalDeviceVulkan12Features vulkan_12_features = {};
+            vulkan_12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+            vulkan_12_features.pNext = nullptr;
+
+            VkPhysicalDeviceFeatures2 physical_device_features = {};
+            physical_device_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            physical_device_features.pNext = &vulkan_12_features;
+
+            vkGetPhysicalDeviceFeatures2(physical_device, &physical_device_features);
+
+            if (!vulkan_12_features.timelineSemaphore)
+            {
+                LOG_TRACE << "Vulkan Backend: This physical device doesn't support timeline semaphores";
+                return false;
+            }
+
+            return true;
+        }
+
         uint32_t Physical_Device_Wrapper::Rate_Physical_Device(VkPhysicalDeviceProperties physical_device_properties)
         {
             uint32_t rating = 0;
@@ -28,7 +28,7 @@ namespace Cascade_Graphics
             LOG_TRACE << "Vulkan Backend: Finished destroying pipelines";
         }
 
-        Identifier Pipeline_Manager::Add_Compute_Pipeline(std::string label, Identifier descriptor_set_identifier, Identifier shader_identifier)
+        Identifier Pipeline_Manager::Add_Compute_Pipeline(std::string label, Identifier descriptor_set_identifier, Identifier shader_identifier, std::vector<uint32_t> specialization_constants)
         {
             Identifier identifier = {};
             identifier.label = label;
@@ -72,6 +72,22 @@ namespace Cascade_Graphics
 
             VALIDATE_VKRESULT(vkCreatePipelineLayout(*m_logical_device_wrapper_ptr->Get_Device(), &pipeline_layout_create_info, nullptr, &m_pipelines.back().pipeline_layout), "Vulkan Backend: Failed to create pipeline layout");
 
+            // Specialization constant i is the i-th value, matching layout(constant_id = i) in the shader
+            std::vector<VkSpecializationMapEntry> specialization_map_entries(specialization_constants.size());
+            for (uint32_t i = 0; i < specialization_constants.size(); i++)
+            {
+                specialization_map_entries[i] = {};
+                specialization_map_entries[i].constantID = i;
+                specialization_map_entries[i].offset = i * sizeof(uint32_t);
+                specialization_map_entries[i].size = sizeof(uint32_t);
+            }
+
+            VkSpecializationInfo specialization_info = {};
+            specialization_info.mapEntryCount = static_cast<uint32_t>(specialization_map_entries.size());
+            specialization_info.pMapEntries = specialization_map_entries.data();
+            specialization_info.dataSize = sizeof(uint32_t) * specialization_constants.size();
+            specialization_info.pData = specialization_constants.data();
+
             VkPipelineShaderStageCreateInfo pipeline_shader_stage_create_info = {};
             pipeline_shader_stage_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
             pipeline_shader_stage_create_info.pNext = nullptr;
@@ -79,7 +95,7 @@ namespace Cascade_Graphics
             pipeline_shader_stage_create_info.stage = VK_SHADER_STAGE_COMPUTE_BIT;
             pipeline_shader_stage_create_info.module = m_shader_manager_ptr->Get_Shader_Data(shader_identifier)->shader_module;
             pipeline_shader_stage_create_info.pName = "main";
-            pipeline_shader_stage_create_info.pSpecializationInfo = nullptr;
+            pipeline_shader_stage_create_info.pSpecializationInfo = specialization_constants.empty() ? nullptr : &specialization_info;
 
             VkComputePipelineCreateInfo compute_pipeline_create_info = {};
             compute_pipeline_create_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
@@ -52,7 +52,7 @@ namespace Cascade_Graphics
             ~Pipeline_Manager();
 
         public:
-            Identifier Add_Compute_Pipeline(std::string label, Identifier descriptor_set_identifier, Identifier shader_identifier);
+            Identifier Add_Compute_Pipeline(std::string label, Identifier descriptor_set_identifier, Identifier shader_identifier, std::vector<uint32_t> specialization_constants = {});
             void Delete_Pipeline(Identifier identifier);
 
             Pipeline_Data* Get_Pipeline_Data(Identifier identifier);
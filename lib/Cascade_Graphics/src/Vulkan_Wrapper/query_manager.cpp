@@ -0,0 +1,141 @@
+#include "query_manager.hpp"
+
+#include "debug_tools.hpp"
+
+
+namespace Cascade_Graphics
+{
+    namespace Vulkan_Backend
+    {
+        Query_Manager::Query_Manager(std::shared_ptr<Logical_Device_Wrapper> logical_device_wrapper_ptr, std::shared_ptr<Physical_Device_Wrapper> physical_device_wrapper_ptr)
+            : m_logical_device_wrapper_ptr(logical_device_wrapper_ptr), m_physical_device_wrapper_ptr(physical_device_wrapper_ptr)
+        {
+            VkPhysicalDeviceProperties physical_device_properties;
+            vkGetPhysicalDeviceProperties(*m_physical_device_wrapper_ptr->Get_Physical_Device(), &physical_device_properties);
+
+            m_timestamp_period = physical_device_properties.limits.timestampPeriod;
+        }
+
+        Query_Manager::~Query_Manager()
+        {
+            LOG_INFO << "Vulkan Backend: Destroying query pools";
+
+            for (uint32_t i = 0; i < m_query_pools.size(); i++)
+            {
+                vkDestroyQueryPool(*m_logical_device_wrapper_ptr->Get_Device(), m_query_pools[i].query_pool, nullptr);
+            }
+
+            LOG_TRACE << "Vulkan Backend: Finished destroying query pools";
+        }
+
+        uint32_t Query_Manager::Get_Next_Query_Pool_Index(std::string label)
+        {
+            uint32_t next_index = 0;
+            for (uint32_t i = 0; i < m_query_pools.size(); i++)
+            {
+                if (label == m_query_pools[i].identifier.label && next_index == m_query_pools[i].identifier.index)
+                {
+                    next_index++;
+                }
+            }
+
+            return next_index;
+        }
+
+        uint32_t Query_Manager::Get_Query_Pool_Index(Identifier identifier)
+        {
+            for (uint32_t i = 0; i < m_query_pools.size(); i++)
+            {
+                if (m_query_pools[i].identifier == identifier)
+                {
+                    return i;
+                }
+            }
+
+            LOG_ERROR << "Vulkan Backend: Cannot find query pool with identifier " << identifier.Get_Identifier_String();
+            exit(EXIT_FAILURE);
+        }
+
+        Identifier Query_Manager::Create_Timestamp_Query_Pool(std::string label, uint32_t query_count)
+        {
+            Identifier identifier = {};
+            identifier.label = label;
+            identifier.index = Get_Next_Query_Pool_Index(label);
+
+            LOG_INFO << "Vulkan Backend: Creating timestamp query pool with identifier " << identifier.Get_Identifier_String();
+
+            VkQueryPoolCreateInfo query_pool_create_info = {};
+            query_pool_create_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            query_pool_create_info.pNext = nullptr;
+            query_pool_create_info.flags = 0;
+            query_pool_create_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            query_pool_create_info.queryCount = query_count;
+            query_pool_create_info.pipelineStatistics = 0;
+
+            m_query_pools.resize(m_query_pools.size() + 1);
+            m_query_pools.back() = {};
+            m_query_pools.back().identifier = identifier;
+            m_query_pools.back().query_count = query_count;
+
+            VALIDATE_VKRESULT(vkCreateQueryPool(*m_logical_device_wrapper_ptr->Get_Device(), &query_pool_create_info, nullptr, &m_query_pools.back().query_pool), "Vulkan Backend: Failed to create query pool");
+
+            LOG_TRACE << "Vulkan Backend: Finished creating timestamp query pool";
+
+            return identifier;
+        }
+
+        void Query_Manager::Destroy_Query_Pool(Identifier identifier)
+        {
+            LOG_TRACE << "Vulkan Backend: Destroying query pool " << identifier.Get_Identifier_String();
+
+            uint32_t query_pool_index = Get_Query_Pool_Index(identifier);
+
+            vkDestroyQueryPool(*m_logical_device_wrapper_ptr->Get_Device(), m_query_pools[query_pool_index].query_pool, nullptr);
+            m_query_pools.erase(m_query_pools.begin() + query_pool_index);
+        }
+
+        bool Query_Manager::Are_Timestamps_Supported(uint32_t queue_family_index)
+        {
+            uint32_t queue_family_count = 0;
+            vkGetPhysicalDeviceQueueFamilyProperties(*m_physical_device_wrapper_ptr->Get_Physical_Device(), &queue_family_count, nullptr);
+            std::vector<VkQueueFamilyProperties> queue_family_properties(queue_family_count);
+            vkGetPhysicalDeviceQueueFamilyProperties(*m_physical_device_wrapper_ptr->Get_Physical_Device(), &queue_family_count, queue_family_properties.data());
+
+            return m_timestamp_period > 0.0 && queue_family_index < queue_family_count && queue_family_properties[queue_family_index].timestampValidBits > 0;
+        }
+
+        bool Query_Manager::Get_Timestamps(Identifier identifier, uint32_t first_query, uint32_t query_count, double* timestamps_ptr)
+        {
+            uint32_t query_pool_index = Get_Query_Pool_Index(identifier);
+
+            if (first_query + query_count > m_query_pools[query_pool_index].query_count)
+            {
+                LOG_ERROR << "Vulkan Backend: Query range out of bounds for query pool " << identifier.Get_Identifier_String();
+                exit(EXIT_FAILURE);
+            }
+
+            std::vector<uint64_t> raw_timestamps(query_count);
+            VkResult query_result = vkGetQueryPoolResults(*m_logical_device_wrapper_ptr->Get_Device(), m_query_pools[query_pool_index].query_pool, first_query, query_count, sizeof(uint64_t) * query_count, raw_timestamps.data(),
+                                                          sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+            // Results of a submission that hasn't finished are not an error, the caller just tries again later
+            if (query_result == VK_NOT_READY)
+            {
+                return false;
+            }
+            VALIDATE_VKRESULT(query_result, "Vulkan Backend: Failed to get query pool results");
+
+            for (uint32_t i = 0; i < query_count; i++)
+            {
+                timestamps_ptr[i] = static_cast<double>(raw_timestamps[i]) * m_timestamp_period;
+            }
+
+            return true;
+        }
+
+        VkQueryPool* Query_Manager::Get_Query_Pool(Identifier identifier)
+        {
+            return &m_query_pools[Get_Query_Pool_Index(identifier)].query_pool;
+        }
+    } // namespace Vulkan_Backend
+} // namespace Cascade_Graphics
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "identifier.hpp"
+#include "logical_device_wrapper.hpp"
+#include "physical_device_wrapper.hpp"
+#include "vulkan_header.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace Cascade_Graphics
+{
+    namespace Vulkan_Backend
+    {
+        class Query_Manager
+        {
+        private:
+            struct Query_Pool
+            {
+                Identifier identifier;
+                VkQueryPool query_pool;
+
+                uint32_t query_count;
+            };
+
+        private:
+            std::vector<Query_Pool> m_query_pools;
+            double m_timestamp_period;
+
+            std::shared_ptr<Logical_Device_Wrapper> m_logical_device_wrapper_ptr;
+            std::shared_ptr<Physical_Device_Wrapper> m_physical_device_wrapper_ptr;
+
+        private:
+            uint32_t Get_Next_Query_Pool_Index(std::string label);
+            uint32_t Get_Query_Pool_Index(Identifier identifier);
+
+        public:
+            Query_Manager(std::shared_ptr<Logical_Device_Wrapper> logical_device_wrapper_ptr, std::shared_ptr<Physical_Device_Wrapper> physical_device_wrapper_ptr);
+            ~Query_Manager();
+
+            Identifier Create_Timestamp_Query_Pool(std::string label, uint32_t query_count);
+            void Destroy_Query_Pool(Identifier identifier);
+
+            bool Are_Timestamps_Supported(uint32_t queue_family_index);
+            bool Get_Timestamps(Identifier identifier, uint32_t first_query, uint32_t query_count, double* timestamps_ptr);
+
+            VkQueryPool* Get_Query_Pool(Identifier identifier);
+        };
+    } // namespace Vulkan_Backend
+} // namespace Cascade_Graphics
\ No newline at end of file
@@ -110,6 +110,11 @@ namespace Cascade_Graphics
         }
 
         Identifier Shader_Manager::Add_Shader(std::string label, std::string path)
+        {
+            return Add_Shader(label, path, "");
+        }
+
+        Identifier Shader_Manager::Add_Shader(std::string label, std::string path, std::string appended_source)
         {
             Identifier identifier = {};
             identifier.label = label;
@@ -143,6 +148,7 @@ namespace Cascade_Graphics
             m_shaders.back().shader_module = VK_NULL_HANDLE;
 
             Load_Shader_Source(identifier);
+            m_shaders.back().shader_source += appended_source;
             Compile_Shader(identifier);
             Create_Shader_Module(identifier);
 
@@ -151,6 +157,25 @@ namespace Cascade_Graphics
             return identifier;
         }
 
+        void Shader_Manager::Remove_Shader(Identifier identifier)
+        {
+            LOG_INFO << "Vulkan Backend: Removing shader " << identifier.Get_Identifier_String();
+
+            for (uint32_t i = 0; i < m_shaders.size(); i++)
+            {
+                if (m_shaders[i].identifier == identifier)
+                {
+                    vkDestroyShaderModule(*m_logical_device_wrapper_ptr->Get_Device(), m_shaders[i].shader_module, nullptr);
+                    m_shaders.erase(m_shaders.begin() + i);
+
+                    return;
+                }
+            }
+
+            LOG_ERROR << "Vulkan Backend: The shader " << identifier.Get_Identifier_String() << " does not exist";
+            exit(EXIT_FAILURE);
+        }
+
         Shader_Manager::Shader_Data* Shader_Manager::Get_Shader_Data(Identifier identifier)
         {
             for (uint32_t i = 0; i < m_shaders.size(); i++)
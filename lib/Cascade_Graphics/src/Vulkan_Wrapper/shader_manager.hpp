@@ -41,6 +41,8 @@ namespace Cascade_Graphics
 
         public:
             Identifier Add_Shader(std::string label, std::string path);
+            Identifier Add_Shader(std::string label, std::string path, std::string appended_source);
+            void Remove_Shader(Identifier identifier);
 
             Shader_Data* Get_Shader_Data(Identifier identifier);
         };
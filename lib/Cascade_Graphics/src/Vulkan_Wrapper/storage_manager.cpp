@@ -1,6 +1,7 @@
 #include "storage_manager.hpp"
 
 #include "debug_tools.hpp"
+#include <algorithm>
 #include <cstring>
 
 
@@ -11,6 +12,7 @@ namespace Cascade_Graphics
         Storage_Manager::Storage_Manager(std::shared_ptr<Logical_Device_Wrapper> logical_device_wrapper_ptr, std::shared_ptr<Physical_Device_Wrapper> physical_device_wrapper_ptr, std::shared_ptr<Queue_Manager> queue_manager_ptr)
             : m_logical_device_wrapper_ptr(logical_device_wrapper_ptr), m_physical_device_wrapper_ptr(physical_device_wrapper_ptr), m_queue_manager_ptr(queue_manager_ptr)
         {
+            m_memory_allocator_ptr = std::make_shared<Memory_Allocator>(m_logical_device_wrapper_ptr, m_physical_device_wrapper_ptr);
         }
 
         Storage_Manager::~Storage_Manager()
@@ -24,7 +26,7 @@ namespace Cascade_Graphics
                 LOG_TRACE << "Vulkan Backend: Destroying buffer " << buffer_resource_ptr->identifier.Get_Identifier_String();
 
                 vkDestroyBuffer(*m_logical_device_wrapper_ptr->Get_Device(), buffer_resource_ptr->buffer, nullptr);
-                vkFreeMemory(*m_logical_device_wrapper_ptr->Get_Device(), buffer_resource_ptr->device_memory, nullptr);
+                m_memory_allocator_ptr->Free(buffer_resource_ptr->memory_allocation);
             }
             m_buffer_resources.clear();
 
@@ -38,12 +40,14 @@ namespace Cascade_Graphics
 
                     vkDestroyImage(*m_logical_device_wrapper_ptr->Get_Device(), image_resource_ptr->image, nullptr);
                     vkDestroyImageView(*m_logical_device_wrapper_ptr->Get_Device(), image_resource_ptr->image_view, nullptr);
-                    vkFreeMemory(*m_logical_device_wrapper_ptr->Get_Device(), image_resource_ptr->device_memory, nullptr);
+                    m_memory_allocator_ptr->Free(image_resource_ptr->memory_allocation);
                 }
             }
             m_image_resources.clear();
             m_resource_groupings.clear();
 
+            m_memory_allocator_ptr.reset();
+
             LOG_TRACE << "Vulkan Backend: Finished cleaning up storage";
         }
 
@@ -141,14 +145,10 @@ namespace Cascade_Graphics
 
             Buffer_Resource* buffer_resource_ptr = Get_Buffer_Resource(identifier);
 
-            VkMemoryAllocateInfo memory_allocate_info = {};
-            memory_allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-            memory_allocate_info.pNext = nullptr;
-            memory_allocate_info.allocationSize = buffer_resource_ptr->memory_requirements.size;
-            memory_allocate_info.memoryTypeIndex = buffer_resource_ptr->memory_type_index;
+            buffer_resource_ptr->memory_allocation = m_memory_allocator_ptr->Allocate(buffer_resource_ptr->memory_requirements, buffer_resource_ptr->memory_type_index, true);
 
-            VALIDATE_VKRESULT(vkAllocateMemory(*m_logical_device_wrapper_ptr->Get_Device(), &memory_allocate_info, nullptr, &buffer_resource_ptr->device_memory), "Vulkan Backend: Failed to allocate buffer memory");
-            VALIDATE_VKRESULT(vkBindBufferMemory(*m_logical_device_wrapper_ptr->Get_Device(), buffer_resource_ptr->buffer, buffer_resource_ptr->device_memory, 0), "Vulkan Backend: Failed to bind buffer memory");
+            VALIDATE_VKRESULT(vkBindBufferMemory(*m_logical_device_wrapper_ptr->Get_Device(), buffer_resource_ptr->buffer, buffer_resource_ptr->memory_allocation.device_memory, buffer_resource_ptr->memory_allocation.offset),
+                              "Vulkan Backend: Failed to bind buffer memory");
         }
 
         void Storage_Manager::Create_VkImage(Identifier identifier)
@@ -208,14 +208,11 @@ namespace Cascade_Graphics
 
             Image_Resource* image_resource_ptr = Get_Image_Resource(identifier);
 
-            VkMemoryAllocateInfo memory_allocate_info = {};
-            memory_allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-            memory_allocate_info.pNext = nullptr;
-            memory_allocate_info.allocationSize = image_resource_ptr->memory_requirements.size;
-            memory_allocate_info.memoryTypeIndex = image_resource_ptr->memory_type_index;
+            // Images are created with optimal tiling, so they are kept apart from the linear buffer allocations
+            image_resource_ptr->memory_allocation = m_memory_allocator_ptr->Allocate(image_resource_ptr->memory_requirements, image_resource_ptr->memory_type_index, false);
 
-            VALIDATE_VKRESULT(vkAllocateMemory(*m_logical_device_wrapper_ptr->Get_Device(), &memory_allocate_info, nullptr, &image_resource_ptr->device_memory), "Vulkan Backend: Failed to allocate image memory");
-            VALIDATE_VKRESULT(vkBindImageMemory(*m_logical_device_wrapper_ptr->Get_Device(), image_resource_ptr->image, image_resource_ptr->device_memory, 0), "Vulkan Backend: Failed to bind image memory");
+            VALIDATE_VKRESULT(vkBindImageMemory(*m_logical_device_wrapper_ptr->Get_Device(), image_resource_ptr->image, image_resource_ptr->memory_allocation.device_memory, image_resource_ptr->memory_allocation.offset),
+                              "Vulkan Backend: Failed to bind image memory");
         }
 
         void Storage_Manager::Create_Image_View(Identifier identifier)
@@ -306,7 +303,7 @@ namespace Cascade_Graphics
             m_buffer_resources.back().memory_property_flags = memory_property_flags;
             m_buffer_resources.back().resource_queue_mask = resource_queue_mask;
             m_buffer_resources.back().buffer = VK_NULL_HANDLE;
-            m_buffer_resources.back().device_memory = VK_NULL_HANDLE;
+            m_buffer_resources.back().memory_allocation = {};
             m_buffer_resources.back().memory_type_index = 0;
 
             Create_VkBuffer(identifier);
@@ -354,7 +351,7 @@ namespace Cascade_Graphics
             m_image_resources.back().resource_queue_mask = resource_queue_mask;
             m_image_resources.back().image = VK_NULL_HANDLE;
             m_image_resources.back().image_view = VK_NULL_HANDLE;
-            m_image_resources.back().device_memory = VK_NULL_HANDLE;
+            m_image_resources.back().memory_allocation = {};
             m_image_resources.back().memory_type_index = 0;
 
             Create_VkImage(identifier);
@@ -469,7 +466,7 @@ namespace Cascade_Graphics
             Buffer_Resource* buffer_resource_ptr = &m_buffer_resources[buffer_index];
 
             vkDestroyBuffer(*m_logical_device_wrapper_ptr->Get_Device(), buffer_resource_ptr->buffer, nullptr);
-            vkFreeMemory(*m_logical_device_wrapper_ptr->Get_Device(), buffer_resource_ptr->device_memory, nullptr);
+            m_memory_allocator_ptr->Free(buffer_resource_ptr->memory_allocation);
             m_buffer_resources.erase(m_buffer_resources.begin() + buffer_index);
         }
 
@@ -484,7 +481,7 @@ namespace Cascade_Graphics
             {
                 vkDestroyImage(*m_logical_device_wrapper_ptr->Get_Device(), image_resource_ptr->image, nullptr);
                 vkDestroyImageView(*m_logical_device_wrapper_ptr->Get_Device(), image_resource_ptr->image_view, nullptr);
-                vkFreeMemory(*m_logical_device_wrapper_ptr->Get_Device(), image_resource_ptr->device_memory, nullptr);
+                m_memory_allocator_ptr->Free(image_resource_ptr->memory_allocation);
             }
 
             m_image_resources.erase(m_image_resources.begin() + image_index);
@@ -505,11 +502,11 @@ namespace Cascade_Graphics
             Buffer_Resource* buffer_resource_ptr = Get_Buffer_Resource(identifier);
 
             vkDestroyBuffer(*m_logical_device_wrapper_ptr->Get_Device(), buffer_resource_ptr->buffer, nullptr);
-            vkFreeMemory(*m_logical_device_wrapper_ptr->Get_Device(), buffer_resource_ptr->device_memory, nullptr);
+            m_memory_allocator_ptr->Free(buffer_resource_ptr->memory_allocation);
 
             buffer_resource_ptr->buffer_size = buffer_size;
             buffer_resource_ptr->buffer = VK_NULL_HANDLE;
-            buffer_resource_ptr->device_memory = VK_NULL_HANDLE;
+            buffer_resource_ptr->memory_allocation = {};
             buffer_resource_ptr->memory_type_index = 0;
 
             Create_VkBuffer(identifier);
@@ -517,18 +514,48 @@ namespace Cascade_Graphics
             Allocate_Buffer_Memory(identifier);
         }
 
-        void Storage_Manager::Upload_To_Buffer_Direct(Identifier identifier, void* data, size_t data_size)
+        Storage_Manager::Buffer_Resource Storage_Manager::Grow_Buffer(Identifier identifier, VkDeviceSize minimum_size)
         {
+            LOG_TRACE << "Vulkan Backend: Growing buffer " << identifier.Get_Identifier_String();
+
             Buffer_Resource* buffer_resource_ptr = Get_Buffer_Resource(identifier);
 
-            if (buffer_resource_ptr->memory_property_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
-            {
-                void* mapped_memory;
-                VALIDATE_VKRESULT(vkMapMemory(*m_logical_device_wrapper_ptr->Get_Device(), buffer_resource_ptr->device_memory, 0, data_size, 0, &mapped_memory), "Vulkan Backend: Failed to map memory");
+            // The old buffer and its memory are handed back to the caller, so its contents can still be copied into the new one
+            Buffer_Resource retired_buffer_resource = *buffer_resource_ptr;
+
+            buffer_resource_ptr->buffer_size = Get_Grown_Buffer_Size(buffer_resource_ptr->buffer_size, minimum_size);
+            buffer_resource_ptr->buffer = VK_NULL_HANDLE;
+            buffer_resource_ptr->memory_allocation = {};
+            buffer_resource_ptr->memory_type_index = 0;
+
+            Create_VkBuffer(identifier);
+            Get_Buffer_Memory_Info(identifier);
+            Allocate_Buffer_Memory(identifier);
 
-                memcpy(mapped_memory, data, data_size);
+            return retired_buffer_resource;
+        }
+
+        void Storage_Manager::Destroy_Retired_Buffer(Buffer_Resource retired_buffer_resource)
+        {
+            LOG_TRACE << "Vulkan Backend: Destroying retired buffer " << retired_buffer_resource.identifier.Get_Identifier_String();
+
+            vkDestroyBuffer(*m_logical_device_wrapper_ptr->Get_Device(), retired_buffer_resource.buffer, nullptr);
+            m_memory_allocator_ptr->Free(retired_buffer_resource.memory_allocation);
+        }
+
+        VkDeviceSize Storage_Manager::Get_Grown_Buffer_Size(VkDeviceSize buffer_size, VkDeviceSize minimum_size)
+        {
+            // Growing by half again keeps the number of reallocations logarithmic without doubling very large buffers
+            return std::max(minimum_size, buffer_size + buffer_size / 2);
+        }
+
+        void Storage_Manager::Upload_To_Buffer_Direct(Identifier identifier, void* data, size_t data_size, VkDeviceSize buffer_offset)
+        {
+            Buffer_Resource* buffer_resource_ptr = Get_Buffer_Resource(identifier);
 
-                vkUnmapMemory(*m_logical_device_wrapper_ptr->Get_Device(), buffer_resource_ptr->device_memory);
+            if (buffer_resource_ptr->memory_property_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+            {
+                memcpy(static_cast<uint8_t*>(buffer_resource_ptr->memory_allocation.mapped_memory_ptr) + buffer_offset, data, data_size);
             }
             else
             {
@@ -537,77 +564,32 @@ namespace Cascade_Graphics
             }
         }
 
-        void Storage_Manager::Upload_To_Buffer_Staging(Identifier identifier, Identifier staging_buffer_identifier, void* data, size_t data_size, std::shared_ptr<Vulkan_Graphics> vulkan_graphics)
+        void Storage_Manager::Download_From_Buffer_Direct(Identifier identifier, void* data, size_t data_size, VkDeviceSize buffer_offset)
         {
-            VALIDATE_VKRESULT(vkDeviceWaitIdle(*m_logical_device_wrapper_ptr->Get_Device()), "Vulkan Backend: Failed to wait for idle device");
-
-            std::chrono::time_point<std::chrono::high_resolution_clock> start_time = std::chrono::high_resolution_clock::now(); //
-
-            Buffer_Resource* staging_buffer = Get_Buffer_Resource(staging_buffer_identifier);
+            Buffer_Resource* buffer_resource_ptr = Get_Buffer_Resource(identifier);
 
-            if (!(staging_buffer->memory_property_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+            if (buffer_resource_ptr->memory_property_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
             {
-                LOG_ERROR << "Vulkan Backend: Staging buffer must have memory property VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT";
+                memcpy(data, static_cast<uint8_t*>(buffer_resource_ptr->memory_allocation.mapped_memory_ptr) + buffer_offset, data_size);
+            }
+            else
+            {
+                LOG_ERROR << "Vulkan Backend: Cannot download from non host-visible buffers";
                 exit(EXIT_FAILURE);
             }
+        }
 
-            Identifier resource_grouping_identifier = Create_Resource_Grouping("staging-buffer-upload", {identifier, staging_buffer_identifier});
-            Identifier descriptor_set_identifier = vulkan_graphics->m_descriptor_set_manager_ptr->Create_Descriptor_Set(resource_grouping_identifier);
-            Identifier uploading_fence_identifier = vulkan_graphics->m_synchronization_manager_ptr->Create_Fence("currently_uploading_fence");
-
-            Identifier empty_pipeline_identifier = {"", 0};
-
-            size_t uploaded = 0;
-            size_t max_upload_size = staging_buffer->buffer_size;
-
-            Identifier command_buffer_identifier = vulkan_graphics->m_command_buffer_manager_ptr->Add_Command_Buffer("staging-buffer-upload", m_queue_manager_ptr->Get_Queue_Family_Index(Queue_Manager::Queue_Types::TRANSFER_QUEUE),
-                                                                                                                     {resource_grouping_identifier}, empty_pipeline_identifier);
+        void* Storage_Manager::Get_Mapped_Memory(Identifier identifier)
+        {
+            Buffer_Resource* buffer_resource_ptr = Get_Buffer_Resource(identifier);
 
-            while (uploaded < data_size)
+            if (!(buffer_resource_ptr->memory_property_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
             {
-                size_t upload_size = std::min<size_t>(data_size - uploaded, max_upload_size);
-
-                VALIDATE_VKRESULT(vkWaitForFences(*vulkan_graphics->m_logical_device_wrapper_ptr->Get_Device(), 1, vulkan_graphics->m_synchronization_manager_ptr->Get_Fence(uploading_fence_identifier), VK_TRUE, UINT64_MAX),
-                                  "Vulkan Backend: Failed to wait for fence");
-                VALIDATE_VKRESULT(vkResetFences(*vulkan_graphics->m_logical_device_wrapper_ptr->Get_Device(), 1, vulkan_graphics->m_synchronization_manager_ptr->Get_Fence(uploading_fence_identifier)), "Vulkan Backend: Failed to reset fence");
-
-                void* mapped_memory;
-                VALIDATE_VKRESULT(vkMapMemory(*m_logical_device_wrapper_ptr->Get_Device(), staging_buffer->device_memory, 0, upload_size, 0, &mapped_memory), "Vulkan Backend: Failed to map memory");
-                memcpy(((uint8_t*)mapped_memory), ((uint8_t*)data) + uploaded, upload_size);
-                vkUnmapMemory(*m_logical_device_wrapper_ptr->Get_Device(), staging_buffer->device_memory);
-
-                vulkan_graphics->m_command_buffer_manager_ptr->Reset_Command_Buffer(command_buffer_identifier);
-
-                vulkan_graphics->m_command_buffer_manager_ptr->Begin_Recording(command_buffer_identifier, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-                vulkan_graphics->m_command_buffer_manager_ptr->Copy_Buffer(command_buffer_identifier, staging_buffer_identifier, identifier, 0, uploaded, upload_size);
-                vulkan_graphics->m_command_buffer_manager_ptr->End_Recording(command_buffer_identifier);
-
-                VkSubmitInfo submit_info = {};
-                submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-                submit_info.pNext = nullptr;
-                submit_info.waitSemaphoreCount = 0;
-                submit_info.pWaitSemaphores = nullptr;
-                submit_info.pWaitDstStageMask = nullptr;
-                submit_info.commandBufferCount = 1;
-                submit_info.pCommandBuffers = vulkan_graphics->m_command_buffer_manager_ptr->Get_Command_Buffer(command_buffer_identifier);
-                submit_info.signalSemaphoreCount = 0;
-                submit_info.pSignalSemaphores = nullptr;
-
-                VALIDATE_VKRESULT(vkQueueSubmit(*m_queue_manager_ptr->Get_Queue(Queue_Manager::Queue_Types::TRANSFER_QUEUE), 1, &submit_info, *vulkan_graphics->m_synchronization_manager_ptr->Get_Fence(uploading_fence_identifier)),
-                                  "Vulkan Backend: Failed to submit staging buffer upload command buffer");
-
-                uploaded += upload_size;
+                LOG_ERROR << "Vulkan Backend: Cannot map non host-visible buffers";
+                exit(EXIT_FAILURE);
             }
 
-            vulkan_graphics->m_descriptor_set_manager_ptr->Remove_Descriptor_Set(descriptor_set_identifier);
-            Remove_Resource_Grouping(resource_grouping_identifier);
-            vulkan_graphics->m_command_buffer_manager_ptr->Remove_Command_Buffer(command_buffer_identifier);
-
-            VALIDATE_VKRESULT(vkDeviceWaitIdle(*m_logical_device_wrapper_ptr->Get_Device()), "Failed to wait for idle device");
-
-            LOG_DEBUG << "Time to upload: " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count() / 1000.0 << " seconds";
-
-            LOG_INFO << "Vulkan Backend: Finished staging buffer upload";
+            return buffer_resource_ptr->memory_allocation.mapped_memory_ptr;
         }
 
         Storage_Manager::Buffer_Resource* Storage_Manager::Get_Buffer_Resource(Identifier identifier)
@@ -624,5 +606,10 @@ namespace Cascade_Graphics
         {
             return &m_resource_groupings[Get_Resource_Grouping_Index(identifier)];
         }
+
+        Memory_Allocator::Memory_Statistics Storage_Manager::Get_Memory_Statistics()
+        {
+            return m_memory_allocator_ptr->Get_Statistics();
+        }
     } // namespace Vulkan_Backend
 } // namespace Cascade_Graphics
\ No newline at end of file
@@ -4,9 +4,9 @@
 
 #include "identifier.hpp"
 #include "logical_device_wrapper.hpp"
+#include "memory_allocator.hpp"
 #include "physical_device_wrapper.hpp"
 #include "queue_manager.hpp"
-#include "vulkan_graphics.hpp"
 #include <string>
 #include <vector>
 
@@ -15,8 +15,6 @@ namespace Cascade_Graphics
 {
     namespace Vulkan_Backend
     {
-        class Vulkan_Graphics;
-
         class Storage_Manager
         {
         public:
@@ -31,7 +29,7 @@ namespace Cascade_Graphics
                 uint32_t resource_queue_mask;
 
                 VkBuffer buffer;
-                VkDeviceMemory device_memory;
+                Memory_Allocator::Allocation memory_allocation;
                 VkMemoryRequirements memory_requirements;
                 uint32_t memory_type_index;
             };
@@ -49,7 +47,7 @@ namespace Cascade_Graphics
 
                 VkImage image;
                 VkImageView image_view;
-                VkDeviceMemory device_memory;
+                Memory_Allocator::Allocation memory_allocation;
                 VkMemoryRequirements memory_requirements;
                 uint32_t memory_type_index;
             };
@@ -71,6 +69,7 @@ namespace Cascade_Graphics
             std::shared_ptr<Logical_Device_Wrapper> m_logical_device_wrapper_ptr;
             std::shared_ptr<Physical_Device_Wrapper> m_physical_device_wrapper_ptr;
             std::shared_ptr<Queue_Manager> m_queue_manager_ptr;
+            std::shared_ptr<Memory_Allocator> m_memory_allocator_ptr;
 
         private:
             uint32_t Get_Buffer_Index(Identifier identifier);
@@ -101,12 +100,17 @@ namespace Cascade_Graphics
             void Remove_Resource_Grouping(Identifier identifier);
 
             void Resize_Buffer(Identifier identifier, VkDeviceSize buffer_size);
-            void Upload_To_Buffer_Direct(Identifier identifier, void* data, size_t data_size);
-            void Upload_To_Buffer_Staging(Identifier identifier, Identifier staging_buffer_identifier, void* data, size_t data_size, std::shared_ptr<Vulkan_Graphics> vulkan_graphics);
+            Buffer_Resource Grow_Buffer(Identifier identifier, VkDeviceSize minimum_size);
+            void Destroy_Retired_Buffer(Buffer_Resource retired_buffer_resource);
+            static VkDeviceSize Get_Grown_Buffer_Size(VkDeviceSize buffer_size, VkDeviceSize minimum_size);
+            void Upload_To_Buffer_Direct(Identifier identifier, void* data, size_t data_size, VkDeviceSize buffer_offset = 0);
+            void Download_From_Buffer_Direct(Identifier identifier, void* data, size_t data_size, VkDeviceSize buffer_offset = 0);
+            void* Get_Mapped_Memory(Identifier identifier);
 
             Buffer_Resource* Get_Buffer_Resource(Identifier identifier);
             Image_Resource* Get_Image_Resource(Identifier identifier);
             Resource_Grouping* Get_Resource_Grouping(Identifier identifier);
+            Memory_Allocator::Memory_Statistics Get_Memory_Statistics();
         };
     } // namespace Vulkan_Backend
 } // namespace Cascade_Graphics
\ No newline at end of file
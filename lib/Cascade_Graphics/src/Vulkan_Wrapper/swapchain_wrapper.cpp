@@ -13,14 +13,16 @@ namespace Cascade_Graphics
                                              std::shared_ptr<Surface_Wrapper> surface_wrapper_ptr,
                                              std::shared_ptr<Queue_Manager> queue_manager_ptr,
                                              uint32_t width,
-                                             uint32_t height)
-            : m_logical_device_wrapper_ptr(logical_device_wrapper_ptr), m_physical_device_wrapper_ptr(physical_device_wrapper_ptr), m_surface_wrapper_ptr(surface_wrapper_ptr), m_queue_manager_ptr(queue_manager_ptr)
+                                             uint32_t height,
+                                             Present_Policy present_policy)
+            : m_present_policy(present_policy), m_logical_device_wrapper_ptr(logical_device_wrapper_ptr), m_physical_device_wrapper_ptr(physical_device_wrapper_ptr), m_surface_wrapper_ptr(surface_wrapper_ptr), m_queue_manager_ptr(queue_manager_ptr)
         {
             LOG_INFO << "Vulkan Backend: Creating swapchain";
 
             Get_Swapchain_Support_Details();
 
             Select_Swapchain_Image_Format();
+            Select_Swapchain_Image_Usage();
             Select_Present_Mode();
             Select_Swapchain_Image_Count();
             Select_Swapchain_Image_Extent(width, height);
@@ -115,16 +117,65 @@ namespace Cascade_Graphics
             LOG_DEBUG << "Vulkan Backend: Selected swapchain color space " << m_surface_format.colorSpace;
         }
 
+        void Swapchain_Wrapper::Select_Swapchain_Image_Usage()
+        {
+            LOG_TRACE << "Vulkan Backend: Selecting swapchain image usage";
+
+            m_swapchain_image_usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+            // Compute shaders can only write to the swapchain images directly if both the surface and the format allow storage use
+            VkFormatProperties format_properties;
+            vkGetPhysicalDeviceFormatProperties(*m_physical_device_wrapper_ptr->Get_Physical_Device(), m_surface_format.format, &format_properties);
+
+            if ((m_surface_capabilities.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT) && (format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT))
+            {
+                m_swapchain_image_usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+            }
+
+            LOG_DEBUG << "Vulkan Backend: Swapchain storage usage " << (Is_Storage_Usage_Supported() ? "is" : "isn't") << " supported";
+        }
+
         void Swapchain_Wrapper::Select_Present_Mode()
         {
             LOG_TRACE << "Vulkan Backend: Selecting present mode";
 
-            for (uint32_t i = 0; i < m_supported_present_modes.size(); i++)
+            // FIFO is the only mode every device has to support, so it ends every list
+            std::vector<VkPresentModeKHR> preferred_present_modes;
+            switch (m_present_policy)
+            {
+                case Present_Policy::VSYNC:
+                {
+                    preferred_present_modes = {VK_PRESENT_MODE_FIFO_KHR};
+                    break;
+                }
+                case Present_Policy::LOW_LATENCY:
+                case Present_Policy::TARGET_FRAME_RATE:
+                {
+                    preferred_present_modes = {VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_KHR};
+                    break;
+                }
+                case Present_Policy::UNCAPPED:
+                {
+                    preferred_present_modes = {VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_KHR};
+                    break;
+                }
+                default:
+                {
+                    LOG_ERROR << "Vulkan Backend: Unknown present policy";
+                    exit(EXIT_FAILURE);
+                }
+            }
+
+            for (uint32_t i = 0; i < preferred_present_modes.size(); i++)
             {
-                if (m_supported_present_modes[i] == VK_PRESENT_MODE_IMMEDIATE_KHR)
+                if (std::find(m_supported_present_modes.begin(), m_supported_present_modes.end(), preferred_present_modes[i]) != m_supported_present_modes.end())
                 {
-                    m_present_mode = m_supported_present_modes[i];
+                    m_present_mode = preferred_present_modes[i];
 
+                    if (i != 0)
+                    {
+                        LOG_WARN << "Vulkan Backend: Preferred present mode " << preferred_present_modes[0] << " isn't supported, falling back to " << m_present_mode;
+                    }
                     LOG_DEBUG << "Vulkan Backend: Selected present mode " << m_present_mode;
 
                     return;
@@ -155,7 +206,27 @@ namespace Cascade_Graphics
         {
             LOG_TRACE << "Vulkan Backend: Selecting swapchain image count";
 
-            m_swapchain_image_count = m_surface_capabilities.minImageCount + 1;
+            switch (m_present_mode)
+            {
+                case VK_PRESENT_MODE_MAILBOX_KHR:
+                {
+                    // One image on screen, one queued and one being rendered, so a newer frame can always replace the queued one
+                    m_swapchain_image_count = std::max(m_surface_capabilities.minImageCount + 1, 3u);
+                    break;
+                }
+                case VK_PRESENT_MODE_IMMEDIATE_KHR:
+                {
+                    // Images are shown as soon as they are presented, so more of them only adds memory
+                    m_swapchain_image_count = std::max(m_surface_capabilities.minImageCount, 2u);
+                    break;
+                }
+                default:
+                {
+                    // One spare image keeps the GPU busy while one is on screen and one waits for the next vblank
+                    m_swapchain_image_count = m_surface_capabilities.minImageCount + 1;
+                    break;
+                }
+            }
 
             if (m_surface_capabilities.maxImageCount != 0 && m_swapchain_image_count > m_surface_capabilities.maxImageCount)
             {
@@ -181,7 +252,7 @@ namespace Cascade_Graphics
             swapchain_create_info.imageColorSpace = m_surface_format.colorSpace;
             swapchain_create_info.imageExtent = m_swapchain_extent;
             swapchain_create_info.imageArrayLayers = 1;
-            swapchain_create_info.imageUsage = SWAPCHAIN_USAGE;
+            swapchain_create_info.imageUsage = m_swapchain_image_usage;
             swapchain_create_info.imageSharingMode = (unique_queues.size() == 1) ? VK_SHARING_MODE_EXCLUSIVE : VK_SHARING_MODE_CONCURRENT;
             swapchain_create_info.queueFamilyIndexCount = static_cast<uint32_t>(unique_queues.size());
             swapchain_create_info.pQueueFamilyIndices = unique_queues.data();
@@ -245,13 +316,13 @@ namespace Cascade_Graphics
                 swapchain_image_resources[i].identifier = {"swapchain", 0};
                 swapchain_image_resources[i].is_swapchain_image = true;
                 swapchain_image_resources[i].image_format = m_surface_format.format;
-                swapchain_image_resources[i].image_usage = SWAPCHAIN_USAGE;
+                swapchain_image_resources[i].image_usage = m_swapchain_image_usage;
                 swapchain_image_resources[i].descriptor_type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
                 swapchain_image_resources[i].image_size = m_swapchain_extent;
                 swapchain_image_resources[i].resource_queue_mask = Queue_Manager::Queue_Types::COMPUTE_QUEUE | Queue_Manager::Queue_Types::PRESENT_QUEUE | Queue_Manager::Queue_Types::TRANSFER_QUEUE;
                 swapchain_image_resources[i].image = m_swapchain_images[i];
                 swapchain_image_resources[i].image_view = m_swapchain_image_views[i];
-                swapchain_image_resources[i].device_memory = VK_NULL_HANDLE;
+                swapchain_image_resources[i].memory_allocation = {};
                 swapchain_image_resources[i].memory_type_index = 0;
             }
 
@@ -277,5 +348,15 @@ namespace Cascade_Graphics
         {
             return m_swapchain_extent;
         }
+
+        VkPresentModeKHR Swapchain_Wrapper::Get_Present_Mode()
+        {
+            return m_present_mode;
+        }
+
+        bool Swapchain_Wrapper::Is_Storage_Usage_Supported()
+        {
+            return m_swapchain_image_usage & VK_IMAGE_USAGE_STORAGE_BIT;
+        }
     } // namespace Vulkan_Backend
 } // namespace Cascade_Graphics
\ No newline at end of file
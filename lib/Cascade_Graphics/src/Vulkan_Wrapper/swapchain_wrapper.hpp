@@ -16,14 +16,23 @@ namespace Cascade_Graphics
     {
         class Swapchain_Wrapper
         {
-        private:
-            static const VkImageUsageFlags SWAPCHAIN_USAGE = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        public:
+            enum Present_Policy
+            {
+                VSYNC,
+                LOW_LATENCY,
+                UNCAPPED,
+                TARGET_FRAME_RATE
+            };
 
+        private:
             VkSwapchainKHR m_swapchain;
             std::vector<VkImage> m_swapchain_images;
             std::vector<VkImageView> m_swapchain_image_views;
 
             VkSurfaceFormatKHR m_surface_format;
+            VkImageUsageFlags m_swapchain_image_usage;
+            Present_Policy m_present_policy;
             VkPresentModeKHR m_present_mode;
             VkExtent2D m_swapchain_extent;
             uint32_t m_swapchain_image_count;
@@ -41,6 +50,7 @@ namespace Cascade_Graphics
             void Get_Swapchain_Support_Details();
 
             void Select_Swapchain_Image_Format();
+            void Select_Swapchain_Image_Usage();
             void Select_Present_Mode();
             void Select_Swapchain_Image_Extent(uint32_t width, uint32_t height);
             void Select_Swapchain_Image_Count();
@@ -55,7 +65,8 @@ namespace Cascade_Graphics
                               std::shared_ptr<Surface_Wrapper> surface_wrapper_ptr,
                               std::shared_ptr<Queue_Manager> queue_manager_ptr,
                               uint32_t width,
-                              uint32_t height);
+                              uint32_t height,
+                              Present_Policy present_policy);
             ~Swapchain_Wrapper();
 
         public:
@@ -65,6 +76,8 @@ namespace Cascade_Graphics
             VkImage* Get_Swapchain_Image(uint32_t index);
             uint32_t Get_Swapchain_Image_Count();
             VkExtent2D Get_Swapchain_Extent();
+            VkPresentModeKHR Get_Present_Mode();
+            bool Is_Storage_Usage_Supported();
         };
     } // namespace Vulkan_Backend
 } // namespace Cascade_Graphics
\ No newline at end of file
@@ -83,6 +83,36 @@ namespace Cascade_Graphics
             return identifier;
         }
 
+        Identifier Synchronization_Manager::Create_Timeline_Semaphore(std::string label, uint64_t initial_value)
+        {
+            Identifier identifier = {};
+            identifier.label = label;
+            identifier.index = Get_Next_Semaphore_Index(label);
+
+            LOG_INFO << "Vulkan Backend: Creating timeline semaphore with identifier " << identifier.Get_Identifier_String();
+
+            VkSemaphoreTypeCreateInfo semaphore_type_create_info = {};
+            semaphore_type_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+            semaphore_type_create_info.pNext = nullptr;
+            semaphore_type_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+            semaphore_type_create_info.initialValue = initial_value;
+
+            VkSemaphoreCreateInfo semaphore_create_info = {};
+            semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            semaphore_create_info.pNext = &semaphore_type_create_info;
+            semaphore_create_info.flags = 0;
+
+            m_semaphores.resize(m_semaphores.size() + 1);
+            m_semaphores.back() = {};
+            m_semaphores.back().identifier = identifier;
+
+            VALIDATE_VKRESULT(vkCreateSemaphore(*m_logical_device_wrapper_ptr->Get_Device(), &semaphore_create_info, nullptr, &m_semaphores.back().semaphore), "Vulkan Backend: Failed to create timeline semaphore");
+
+            LOG_TRACE << "Vulkan Backend: Finished creating timeline semaphore";
+
+            return identifier;
+        }
+
         Identifier Synchronization_Manager::Create_Fence(std::string label)
         {
             Identifier identifier = {};
@@ -180,6 +210,27 @@ namespace Cascade_Graphics
             exit(EXIT_FAILURE);
         }
 
+        uint64_t Synchronization_Manager::Get_Timeline_Semaphore_Value(Identifier identifier)
+        {
+            uint64_t value;
+            VALIDATE_VKRESULT(vkGetSemaphoreCounterValue(*m_logical_device_wrapper_ptr->Get_Device(), *Get_Semaphore(identifier), &value), "Vulkan Backend: Failed to get timeline semaphore value");
+
+            return value;
+        }
+
+        void Synchronization_Manager::Wait_For_Timeline_Semaphore(Identifier identifier, uint64_t value)
+        {
+            VkSemaphoreWaitInfo semaphore_wait_info = {};
+            semaphore_wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            semaphore_wait_info.pNext = nullptr;
+            semaphore_wait_info.flags = 0;
+            semaphore_wait_info.semaphoreCount = 1;
+            semaphore_wait_info.pSemaphores = Get_Semaphore(identifier);
+            semaphore_wait_info.pValues = &value;
+
+            VALIDATE_VKRESULT(vkWaitSemaphores(*m_logical_device_wrapper_ptr->Get_Device(), &semaphore_wait_info, UINT64_MAX), "Vulkan Backend: Failed to wait for timeline semaphore");
+        }
+
         VkFence* Synchronization_Manager::Get_Fence(Identifier identifier)
         {
             for (uint32_t i = 0; i < m_fences.size(); i++)
@@ -44,6 +44,7 @@ namespace Cascade_Graphics
             ~Synchronization_Manager();
 
             Identifier Create_Semaphore(std::string label);
+            Identifier Create_Timeline_Semaphore(std::string label, uint64_t initial_value);
             Identifier Create_Fence(std::string label);
             Identifier Add_Fence(std::string label, VkFence fence);
 
@@ -51,6 +52,8 @@ namespace Cascade_Graphics
             void Destroy_Fence(Identifier identifier);
 
             VkSemaphore* Get_Semaphore(Identifier identifier);
+            uint64_t Get_Timeline_Semaphore_Value(Identifier identifier);
+            void Wait_For_Timeline_Semaphore(Identifier identifier, uint64_t value);
             VkFence* Get_Fence(Identifier identifier);
         };
     } // namespace Vulkan_Backend
@@ -0,0 +1,515 @@
+#include "transfer_manager.hpp"
+
+#include "debug_tools.hpp"
+#include <algorithm>
+#include <cstring>
+
+
+namespace Cascade_Graphics
+{
+    namespace Vulkan_Backend
+    {
+        Transfer_Manager::Transfer_Manager(std::shared_ptr<Command_Buffer_Manager> command_buffer_manager_ptr,
+                                           std::shared_ptr<Logical_Device_Wrapper> logical_device_wrapper_ptr,
+                                           std::shared_ptr<Queue_Manager> queue_manager_ptr,
+                                           std::shared_ptr<Storage_Manager> storage_manager_ptr,
+                                           std::shared_ptr<Synchronization_Manager> synchronization_manager_ptr,
+                                           std::mutex* vulkan_objects_access_mutex_ptr,
+                                           VkDeviceSize staging_buffer_size)
+            : m_staging_buffer_size(staging_buffer_size), m_vulkan_objects_access_mutex_ptr(vulkan_objects_access_mutex_ptr), m_command_buffer_manager_ptr(command_buffer_manager_ptr), m_logical_device_wrapper_ptr(logical_device_wrapper_ptr),
+              m_queue_manager_ptr(queue_manager_ptr), m_storage_manager_ptr(storage_manager_ptr), m_synchronization_manager_ptr(synchronization_manager_ptr)
+        {
+            LOG_INFO << "Vulkan Backend: Creating transfer manager";
+
+            // Every submission signals the next value, so a single value is enough to tell when a transfer is done
+            m_timeline_semaphore_identifier = m_synchronization_manager_ptr->Create_Timeline_Semaphore("transfer_timeline_semaphore", m_timeline_value);
+
+            // The handle is kept so staging can wait for the ring without looking the semaphore up in the shared synchronization manager
+            m_timeline_semaphore = *m_synchronization_manager_ptr->Get_Semaphore(m_timeline_semaphore_identifier);
+
+            // A bounded ring in plain host memory, leaving the small device-local host-visible heap to the resources that need it
+            m_staging_buffer_identifier = m_storage_manager_ptr->Create_Buffer("staging_buffer", m_staging_buffer_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                                               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, Queue_Manager::TRANSFER_QUEUE);
+            m_staging_memory_ptr = static_cast<uint8_t*>(m_storage_manager_ptr->Get_Mapped_Memory(m_staging_buffer_identifier));
+
+            LOG_TRACE << "Vulkan Backend: Finished creating transfer manager";
+        }
+
+        Transfer_Manager::~Transfer_Manager()
+        {
+            LOG_INFO << "Vulkan Backend: Destroying transfer manager";
+
+            Wait_For_Timeline_Value(m_timeline_value);
+
+            for (uint32_t i = 0; i < m_transfer_command_buffers.size(); i++)
+            {
+                m_command_buffer_manager_ptr->Remove_Command_Buffer(m_transfer_command_buffers[i].command_buffer_identifier);
+            }
+            m_transfer_command_buffers.clear();
+
+            Destroy_Completed_Retired_Buffers();
+
+            m_storage_manager_ptr->Destroy_Buffer(m_staging_buffer_identifier);
+            m_staging_regions.clear();
+
+            m_synchronization_manager_ptr->Destroy_Semaphore(m_timeline_semaphore_identifier);
+
+            LOG_TRACE << "Vulkan Backend: Finished destroying transfer manager";
+        }
+
+        uint64_t Transfer_Manager::Get_Completed_Timeline_Value()
+        {
+            uint64_t completed_timeline_value;
+            VALIDATE_VKRESULT(vkGetSemaphoreCounterValue(*m_logical_device_wrapper_ptr->Get_Device(), m_timeline_semaphore, &completed_timeline_value), "Vulkan Backend: Failed to get transfer timeline value");
+
+            return completed_timeline_value;
+        }
+
+        void Transfer_Manager::Wait_For_Timeline_Value(uint64_t timeline_value)
+        {
+            VkSemaphoreWaitInfo semaphore_wait_info = {};
+            semaphore_wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            semaphore_wait_info.pNext = nullptr;
+            semaphore_wait_info.flags = 0;
+            semaphore_wait_info.semaphoreCount = 1;
+            semaphore_wait_info.pSemaphores = &m_timeline_semaphore;
+            semaphore_wait_info.pValues = &timeline_value;
+
+            VALIDATE_VKRESULT(vkWaitSemaphores(*m_logical_device_wrapper_ptr->Get_Device(), &semaphore_wait_info, UINT64_MAX), "Vulkan Backend: Failed to wait for transfer timeline value");
+        }
+
+        uint32_t Transfer_Manager::Begin_Transfer_Command_Buffer(Queue_Manager::Queue_Types queue_type)
+        {
+            uint64_t completed_timeline_value = Get_Completed_Timeline_Value();
+
+            // Reuse a command buffer whose last submission has finished, only allocating another when all of them are still in use
+            int32_t transfer_command_buffer_index = -1;
+            for (uint32_t i = 0; i < m_transfer_command_buffers.size(); i++)
+            {
+                if (m_transfer_command_buffers[i].queue_type == queue_type && m_transfer_command_buffers[i].timeline_value <= completed_timeline_value)
+                {
+                    transfer_command_buffer_index = i;
+                    break;
+                }
+            }
+
+            if (transfer_command_buffer_index == -1)
+            {
+                transfer_command_buffer_index = static_cast<int32_t>(m_transfer_command_buffers.size());
+
+                m_transfer_command_buffers.resize(m_transfer_command_buffers.size() + 1);
+                m_transfer_command_buffers.back() = {};
+                m_transfer_command_buffers.back().command_buffer_identifier
+                    = m_command_buffer_manager_ptr->Add_Command_Buffer("transfer_command_buffer", m_queue_manager_ptr->Get_Queue_Family_Index(queue_type), {}, {"", 0});
+                m_transfer_command_buffers.back().queue_type = queue_type;
+                m_transfer_command_buffers.back().timeline_value = 0;
+            }
+
+            m_command_buffer_manager_ptr->Reset_Command_Buffer(m_transfer_command_buffers[transfer_command_buffer_index].command_buffer_identifier);
+            m_command_buffer_manager_ptr->Begin_Recording(m_transfer_command_buffers[transfer_command_buffer_index].command_buffer_identifier, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+            return transfer_command_buffer_index;
+        }
+
+        uint64_t Transfer_Manager::Submit_Transfer_Command_Buffer(uint32_t transfer_command_buffer_index, VkSemaphore wait_semaphore, uint64_t wait_value, VkPipelineStageFlags wait_stage_flags)
+        {
+            Transfer_Command_Buffer* transfer_command_buffer_ptr = &m_transfer_command_buffers[transfer_command_buffer_index];
+
+            m_command_buffer_manager_ptr->End_Recording(transfer_command_buffer_ptr->command_buffer_identifier);
+
+            // Each submission also waits for the previous one, so values are signalled in order even when submissions alternate between queues
+            std::vector<VkSemaphore> wait_semaphores = {m_timeline_semaphore};
+            std::vector<uint64_t> wait_values = {m_timeline_value};
+            std::vector<VkPipelineStageFlags> wait_stage_masks = {VK_PIPELINE_STAGE_ALL_COMMANDS_BIT};
+            if (wait_semaphore != VK_NULL_HANDLE)
+            {
+                wait_semaphores.push_back(wait_semaphore);
+                wait_values.push_back(wait_value);
+                wait_stage_masks.push_back(wait_stage_flags);
+            }
+
+            m_timeline_value++;
+            transfer_command_buffer_ptr->timeline_value = m_timeline_value;
+
+            VkTimelineSemaphoreSubmitInfo timeline_semaphore_submit_info = {};
+            timeline_semaphore_submit_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+            timeline_semaphore_submit_info.pNext = nullptr;
+            timeline_semaphore_submit_info.waitSemaphoreValueCount = static_cast<uint32_t>(wait_values.size());
+            timeline_semaphore_submit_info.pWaitSemaphoreValues = wait_values.data();
+            timeline_semaphore_submit_info.signalSemaphoreValueCount = 1;
+            timeline_semaphore_submit_info.pSignalSemaphoreValues = &m_timeline_value;
+
+            VkSubmitInfo submit_info = {};
+            submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submit_info.pNext = &timeline_semaphore_submit_info;
+            submit_info.waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores.size());
+            submit_info.pWaitSemaphores = wait_semaphores.data();
+            submit_info.pWaitDstStageMask = wait_stage_masks.data();
+            submit_info.commandBufferCount = 1;
+            submit_info.pCommandBuffers = m_command_buffer_manager_ptr->Get_Command_Buffer(transfer_command_buffer_ptr->command_buffer_identifier);
+            submit_info.signalSemaphoreCount = 1;
+            submit_info.pSignalSemaphores = &m_timeline_semaphore;
+
+            VALIDATE_VKRESULT(vkQueueSubmit(*m_queue_manager_ptr->Get_Queue(transfer_command_buffer_ptr->queue_type), 1, &submit_info, VK_NULL_HANDLE), "Vulkan Backend: Failed to submit transfer command buffer");
+
+            return m_timeline_value;
+        }
+
+        void Transfer_Manager::Release_Completed_Staging_Regions()
+        {
+            uint64_t completed_timeline_value = Get_Completed_Timeline_Value();
+
+            while (!m_staging_regions.empty() && m_staging_regions.front().timeline_value <= completed_timeline_value)
+            {
+                m_staging_regions.pop_front();
+            }
+
+            if (m_staging_regions.empty())
+            {
+                m_staging_head = 0;
+            }
+        }
+
+        VkDeviceSize Transfer_Manager::Allocate_Staging_Region(VkDeviceSize size, uint64_t& region_index)
+        {
+            // Keep regions aligned so elements written through the mapping stay naturally aligned
+            const VkDeviceSize region_alignment = 16;
+
+            std::unique_lock<std::mutex> transfer_lock(m_transfer_mutex);
+
+            while (true)
+            {
+                Release_Completed_Staging_Regions();
+
+                VkDeviceSize offset = (m_staging_head + region_alignment - 1) / region_alignment * region_alignment;
+                bool region_found = false;
+
+                if (m_staging_regions.empty())
+                {
+                    offset = 0;
+                    region_found = size <= m_staging_buffer_size;
+                }
+                else if (m_staging_regions.back().offset >= m_staging_regions.front().offset)
+                {
+                    // Regions in use are contiguous, so there is free space after the head and before the oldest region
+                    if (offset + size <= m_staging_buffer_size)
+                    {
+                        region_found = true;
+                    }
+                    else if (size <= m_staging_regions.front().offset)
+                    {
+                        offset = 0;
+                        region_found = true;
+                    }
+                }
+                else
+                {
+                    // The head has wrapped around, so only the space up to the oldest region is free
+                    region_found = offset + size <= m_staging_regions.front().offset;
+                }
+
+                if (region_found)
+                {
+                    region_index = m_next_staging_region_index++;
+
+                    m_staging_regions.push_back({region_index, offset, size, UINT64_MAX});
+                    m_staging_head = offset + size;
+
+                    return offset;
+                }
+
+                // The ring is full, the oldest region may still be written by another caller, otherwise its copy is waited for without holding the ring
+                if (m_staging_regions.front().timeline_value == UINT64_MAX)
+                {
+                    m_staging_region_notify.wait(transfer_lock);
+                }
+                else
+                {
+                    uint64_t timeline_value = m_staging_regions.front().timeline_value;
+
+                    transfer_lock.unlock();
+                    Wait_For_Timeline_Value(timeline_value);
+                    transfer_lock.lock();
+                }
+            }
+        }
+
+        void Transfer_Manager::Submit_Staging_Region(uint64_t region_index, uint64_t timeline_value)
+        {
+            std::lock_guard<std::mutex> transfer_lock(m_transfer_mutex);
+
+            for (uint32_t i = 0; i < m_staging_regions.size(); i++)
+            {
+                if (m_staging_regions[i].region_index == region_index)
+                {
+                    m_staging_regions[i].timeline_value = timeline_value;
+                    break;
+                }
+            }
+
+            m_staging_region_notify.notify_all();
+        }
+
+        void Transfer_Manager::Destroy_Completed_Retired_Buffers()
+        {
+            uint64_t completed_timeline_value = Get_Completed_Timeline_Value();
+
+            for (int32_t i = static_cast<int32_t>(m_retired_buffers.size()) - 1; i >= 0; i--)
+            {
+                if (m_retired_buffers[i].timeline_value <= completed_timeline_value)
+                {
+                    m_storage_manager_ptr->Destroy_Retired_Buffer(m_retired_buffers[i].buffer_resource);
+                    m_retired_buffers.erase(m_retired_buffers.begin() + i);
+                }
+            }
+        }
+
+        uint64_t Transfer_Manager::Upload_To_Buffer(Identifier identifier,
+                                                    const void* data,
+                                                    size_t data_size,
+                                                    Queue_Manager::Queue_Types destination_queue_type,
+                                                    VkSemaphore wait_semaphore,
+                                                    const uint64_t* wait_value_ptr,
+                                                    uint64_t* transfer_ticket_ptr)
+        {
+            return Upload_To_Buffer(
+                identifier, 1, 0, data_size, [data](void* mapped_memory, size_t first_element, size_t element_count) { memcpy(mapped_memory, ((const uint8_t*)data) + first_element, element_count); },
+                destination_queue_type, wait_semaphore, wait_value_ptr, transfer_ticket_ptr);
+        }
+
+        uint64_t Transfer_Manager::Upload_To_Buffer(Identifier identifier,
+                                                    size_t element_size,
+                                                    size_t first_element,
+                                                    size_t element_count,
+                                                    std::function<void(void*, size_t, size_t)> write_elements_function,
+                                                    Queue_Manager::Queue_Types destination_queue_type,
+                                                    VkSemaphore wait_semaphore,
+                                                    const uint64_t* wait_value_ptr,
+                                                    uint64_t* transfer_ticket_ptr)
+        {
+            // The ring is only locked to hand out and retire regions and the Vulkan objects only to record and submit, so elements are written while other callers stage and frames are rendered
+            LOG_TRACE << "Vulkan Backend: Uploading to buffer " << identifier.Get_Identifier_String();
+
+            // Large uploads are split so other subsystems can keep staging data while earlier chunks are copied
+            size_t data_size = element_size * element_count;
+            size_t max_chunk_size = static_cast<size_t>(m_staging_buffer_size / 4);
+            size_t max_upload_size = max_chunk_size - (max_chunk_size % element_size);
+
+            if (data_size == 0)
+            {
+                std::lock_guard<std::mutex> vulkan_objects_access_lock(*m_vulkan_objects_access_mutex_ptr);
+                return m_timeline_value;
+            }
+            if (max_upload_size == 0)
+            {
+                LOG_ERROR << "Vulkan Backend: Staging ring is too small to hold a single element";
+                exit(EXIT_FAILURE);
+            }
+
+            uint32_t transfer_queue_family;
+            uint32_t destination_queue_family;
+            bool ownership_transfer;
+            {
+                std::lock_guard<std::mutex> vulkan_objects_access_lock(*m_vulkan_objects_access_mutex_ptr);
+
+                // Buffers shared concurrently can be used from the transfer queue as they are, exclusively owned ones are handed over and back
+                transfer_queue_family = m_queue_manager_ptr->Get_Queue_Family_Index(Queue_Manager::Queue_Types::TRANSFER_QUEUE);
+                destination_queue_family = m_queue_manager_ptr->Get_Queue_Family_Index(destination_queue_type);
+                std::vector<uint32_t> buffer_queue_families = m_queue_manager_ptr->Get_Unique_Queue_Families(m_storage_manager_ptr->Get_Buffer_Resource(identifier)->resource_queue_mask);
+                ownership_transfer = buffer_queue_families.size() == 1 && buffer_queue_families.front() != transfer_queue_family;
+
+                if (ownership_transfer && buffer_queue_families.front() != destination_queue_family)
+                {
+                    LOG_ERROR << "Vulkan Backend: Buffer " << identifier.Get_Identifier_String() << " isn't owned by the destination queue family";
+                    exit(EXIT_FAILURE);
+                }
+
+                if (ownership_transfer)
+                {
+                    uint32_t release_command_buffer_index = Begin_Transfer_Command_Buffer(destination_queue_type);
+                    m_command_buffer_manager_ptr->Buffer_Memory_Barrier(m_transfer_command_buffers[release_command_buffer_index].command_buffer_identifier, identifier, VK_ACCESS_MEMORY_WRITE_BIT, 0, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                                                        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, destination_queue_family, transfer_queue_family);
+                    Submit_Transfer_Command_Buffer(release_command_buffer_index, wait_semaphore, (wait_value_ptr != nullptr) ? *wait_value_ptr : 0, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+                }
+            }
+
+            size_t uploaded = 0;
+            while (uploaded < data_size)
+            {
+                size_t upload_size = std::min<size_t>(data_size - uploaded, max_upload_size);
+
+                uint64_t staging_region_index;
+                VkDeviceSize staging_offset = Allocate_Staging_Region(upload_size, staging_region_index);
+                write_elements_function(m_staging_memory_ptr + staging_offset, first_element + uploaded / element_size, upload_size / element_size);
+
+                std::unique_lock<std::mutex> vulkan_objects_access_lock(*m_vulkan_objects_access_mutex_ptr);
+
+                uint32_t copy_command_buffer_index = Begin_Transfer_Command_Buffer(Queue_Manager::Queue_Types::TRANSFER_QUEUE);
+                Identifier copy_command_buffer_identifier = m_transfer_command_buffers[copy_command_buffer_index].command_buffer_identifier;
+
+                if (ownership_transfer && uploaded == 0)
+                {
+                    m_command_buffer_manager_ptr->Buffer_Memory_Barrier(copy_command_buffer_identifier, identifier, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, destination_queue_family,
+                                                                        transfer_queue_family);
+                }
+
+                m_command_buffer_manager_ptr->Copy_Buffer(copy_command_buffer_identifier, m_staging_buffer_identifier, identifier, staging_offset, first_element * element_size + uploaded, upload_size);
+
+                if (ownership_transfer && uploaded + upload_size == data_size)
+                {
+                    m_command_buffer_manager_ptr->Buffer_Memory_Barrier(copy_command_buffer_identifier, identifier, VK_ACCESS_TRANSFER_WRITE_BIT, 0, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, transfer_queue_family,
+                                                                        destination_queue_family);
+                }
+
+                // Work submitted while earlier chunks were staged is waited for, and work submitted after this chunk waits for it
+                uint64_t transfer_ticket = Submit_Transfer_Command_Buffer(copy_command_buffer_index, wait_semaphore, (wait_value_ptr != nullptr) ? *wait_value_ptr : 0, VK_PIPELINE_STAGE_TRANSFER_BIT);
+                if (transfer_ticket_ptr != nullptr)
+                {
+                    *transfer_ticket_ptr = std::max(*transfer_ticket_ptr, transfer_ticket);
+                }
+
+                vulkan_objects_access_lock.unlock();
+
+                Submit_Staging_Region(staging_region_index, transfer_ticket);
+
+                uploaded += upload_size;
+            }
+
+            std::lock_guard<std::mutex> vulkan_objects_access_lock(*m_vulkan_objects_access_mutex_ptr);
+
+            if (ownership_transfer)
+            {
+                uint32_t acquire_command_buffer_index = Begin_Transfer_Command_Buffer(destination_queue_type);
+                m_command_buffer_manager_ptr->Buffer_Memory_Barrier(m_transfer_command_buffers[acquire_command_buffer_index].command_buffer_identifier, identifier, 0, VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
+                                                                    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, transfer_queue_family, destination_queue_family);
+                Submit_Transfer_Command_Buffer(acquire_command_buffer_index, VK_NULL_HANDLE, 0, 0);
+
+                if (transfer_ticket_ptr != nullptr)
+                {
+                    *transfer_ticket_ptr = std::max(*transfer_ticket_ptr, m_timeline_value);
+                }
+            }
+
+            LOG_TRACE << "Vulkan Backend: Submitted upload to buffer " << identifier.Get_Identifier_String() << " as transfer " << m_timeline_value;
+
+            return m_timeline_value;
+        }
+
+        void Transfer_Manager::Download_From_Buffer(Identifier identifier, void* data, size_t data_size, VkDeviceSize buffer_offset)
+        {
+            LOG_TRACE << "Vulkan Backend: Downloading from buffer " << identifier.Get_Identifier_String();
+
+            size_t max_download_size = static_cast<size_t>(m_staging_buffer_size / 4);
+
+            size_t downloaded = 0;
+            while (downloaded < data_size)
+            {
+                size_t download_size = std::min<size_t>(data_size - downloaded, max_download_size);
+
+                uint64_t staging_region_index;
+                VkDeviceSize staging_offset = Allocate_Staging_Region(download_size, staging_region_index);
+
+                uint64_t transfer_ticket;
+                {
+                    std::lock_guard<std::mutex> vulkan_objects_access_lock(*m_vulkan_objects_access_mutex_ptr);
+
+                    if (!(m_storage_manager_ptr->Get_Buffer_Resource(identifier)->resource_queue_mask & Queue_Manager::Queue_Types::TRANSFER_QUEUE))
+                    {
+                        LOG_ERROR << "Vulkan Backend: Buffer " << identifier.Get_Identifier_String() << " must be usable from the transfer queue to be downloaded";
+                        exit(EXIT_FAILURE);
+                    }
+
+                    uint32_t copy_command_buffer_index = Begin_Transfer_Command_Buffer(Queue_Manager::Queue_Types::TRANSFER_QUEUE);
+                    m_command_buffer_manager_ptr->Copy_Buffer(m_transfer_command_buffers[copy_command_buffer_index].command_buffer_identifier, identifier, m_staging_buffer_identifier, buffer_offset + downloaded, staging_offset, download_size);
+                    transfer_ticket = Submit_Transfer_Command_Buffer(copy_command_buffer_index, VK_NULL_HANDLE, 0, 0);
+                }
+
+                // The region keeps its unsubmitted value until it has been read, so the ring cannot hand it out again in the meantime
+                Wait_For_Timeline_Value(transfer_ticket);
+                memcpy(static_cast<uint8_t*>(data) + downloaded, m_staging_memory_ptr + staging_offset, download_size);
+                Submit_Staging_Region(staging_region_index, transfer_ticket);
+
+                downloaded += download_size;
+            }
+        }
+
+        uint64_t Transfer_Manager::Copy_Buffer(Identifier source_identifier,
+                                               Identifier destination_identifier,
+                                               VkDeviceSize source_offset,
+                                               VkDeviceSize destination_offset,
+                                               VkDeviceSize copy_size,
+                                               VkSemaphore wait_semaphore,
+                                               uint64_t wait_value)
+        {
+            if (!(m_storage_manager_ptr->Get_Buffer_Resource(source_identifier)->resource_queue_mask & Queue_Manager::Queue_Types::TRANSFER_QUEUE)
+                || !(m_storage_manager_ptr->Get_Buffer_Resource(destination_identifier)->resource_queue_mask & Queue_Manager::Queue_Types::TRANSFER_QUEUE))
+            {
+                LOG_ERROR << "Vulkan Backend: Buffers " << source_identifier.Get_Identifier_String() << " and " << destination_identifier.Get_Identifier_String() << " must be usable from the transfer queue to be copied";
+                exit(EXIT_FAILURE);
+            }
+
+            uint32_t copy_command_buffer_index = Begin_Transfer_Command_Buffer(Queue_Manager::Queue_Types::TRANSFER_QUEUE);
+            m_command_buffer_manager_ptr->Copy_Buffer(m_transfer_command_buffers[copy_command_buffer_index].command_buffer_identifier, source_identifier, destination_identifier, source_offset, destination_offset, copy_size);
+
+            return Submit_Transfer_Command_Buffer(copy_command_buffer_index, wait_semaphore, wait_value, VK_PIPELINE_STAGE_TRANSFER_BIT);
+        }
+
+        uint64_t Transfer_Manager::Grow_Buffer(Identifier identifier, VkDeviceSize minimum_size, VkSemaphore wait_semaphore, uint64_t wait_value)
+        {
+            // Everything touched here is guarded by the Vulkan objects mutex the caller holds, the staging ring isn't used
+            Destroy_Completed_Retired_Buffers();
+
+            Storage_Manager::Buffer_Resource* buffer_resource_ptr = m_storage_manager_ptr->Get_Buffer_Resource(identifier);
+
+            if (buffer_resource_ptr->buffer_size >= minimum_size)
+            {
+                return m_timeline_value;
+            }
+            if ((buffer_resource_ptr->buffer_usage & (VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)) != (VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT))
+            {
+                LOG_ERROR << "Vulkan Backend: Buffer " << identifier.Get_Identifier_String() << " needs VK_BUFFER_USAGE_TRANSFER_SRC_BIT and VK_BUFFER_USAGE_TRANSFER_DST_BIT to be grown";
+                exit(EXIT_FAILURE);
+            }
+            if (!(buffer_resource_ptr->resource_queue_mask & Queue_Manager::Queue_Types::TRANSFER_QUEUE))
+            {
+                LOG_ERROR << "Vulkan Backend: Buffer " << identifier.Get_Identifier_String() << " must be usable from the transfer queue to be grown";
+                exit(EXIT_FAILURE);
+            }
+
+            Storage_Manager::Buffer_Resource retired_buffer_resource = m_storage_manager_ptr->Grow_Buffer(identifier, minimum_size);
+
+            LOG_DEBUG << "Vulkan Backend: Grew buffer " << identifier.Get_Identifier_String() << " from " << retired_buffer_resource.buffer_size << " to " << m_storage_manager_ptr->Get_Buffer_Resource(identifier)->buffer_size << " bytes";
+
+            uint32_t copy_command_buffer_index = Begin_Transfer_Command_Buffer(Queue_Manager::Queue_Types::TRANSFER_QUEUE);
+
+            VkBufferCopy buffer_copy = {};
+            buffer_copy.srcOffset = 0;
+            buffer_copy.dstOffset = 0;
+            buffer_copy.size = retired_buffer_resource.buffer_size;
+
+            vkCmdCopyBuffer(*m_command_buffer_manager_ptr->Get_Command_Buffer(m_transfer_command_buffers[copy_command_buffer_index].command_buffer_identifier), retired_buffer_resource.buffer,
+                            m_storage_manager_ptr->Get_Buffer_Resource(identifier)->buffer, 1, &buffer_copy);
+
+            // The old buffer is destroyed once the copy has finished, callers still have to make sure no frame references it any more
+            uint64_t transfer_ticket = Submit_Transfer_Command_Buffer(copy_command_buffer_index, wait_semaphore, wait_value, VK_PIPELINE_STAGE_TRANSFER_BIT);
+            m_retired_buffers.push_back({retired_buffer_resource, transfer_ticket});
+
+            return transfer_ticket;
+        }
+
+        bool Transfer_Manager::Is_Transfer_Complete(uint64_t transfer_ticket)
+        {
+            return Get_Completed_Timeline_Value() >= transfer_ticket;
+        }
+
+        void Transfer_Manager::Wait_For_Transfer(uint64_t transfer_ticket)
+        {
+            Wait_For_Timeline_Value(transfer_ticket);
+        }
+
+        VkSemaphore* Transfer_Manager::Get_Timeline_Semaphore()
+        {
+            return &m_timeline_semaphore;
+        }
+    } // namespace Vulkan_Backend
+} // namespace Cascade_Graphics
\ No newline at end of file
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "command_buffer_manager.hpp"
+#include "identifier.hpp"
+#include "logical_device_wrapper.hpp"
+#include "queue_manager.hpp"
+#include "storage_manager.hpp"
+#include "synchronization_manager.hpp"
+#include "vulkan_header.hpp"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace Cascade_Graphics
+{
+    namespace Vulkan_Backend
+    {
+        class Transfer_Manager
+        {
+        private:
+            struct Transfer_Command_Buffer
+            {
+                Identifier command_buffer_identifier;
+                Queue_Manager::Queue_Types queue_type;
+
+                uint64_t timeline_value;
+            };
+
+            struct Retired_Buffer
+            {
+                Storage_Manager::Buffer_Resource buffer_resource;
+
+                uint64_t timeline_value;
+            };
+
+            struct Staging_Region
+            {
+                uint64_t region_index;
+                VkDeviceSize offset;
+                VkDeviceSize size;
+
+                uint64_t timeline_value;
+            };
+
+        private:
+            // Guarded by the Vulkan objects mutex, like the managers they are recorded and submitted with
+            Identifier m_timeline_semaphore_identifier;
+            VkSemaphore m_timeline_semaphore;
+            uint64_t m_timeline_value = 0;
+
+            std::vector<Transfer_Command_Buffer> m_transfer_command_buffers;
+            std::vector<Retired_Buffer> m_retired_buffers;
+
+            // Guarded by m_transfer_mutex, which is only held to hand out and retire regions, so several callers can write their regions at once
+            Identifier m_staging_buffer_identifier;
+            VkDeviceSize m_staging_buffer_size;
+            uint8_t* m_staging_memory_ptr;
+            VkDeviceSize m_staging_head = 0;
+            uint64_t m_next_staging_region_index = 0;
+            std::deque<Staging_Region> m_staging_regions;
+
+            std::mutex m_transfer_mutex;
+            std::condition_variable m_staging_region_notify;
+            std::mutex* m_vulkan_objects_access_mutex_ptr;
+
+            std::shared_ptr<Command_Buffer_Manager> m_command_buffer_manager_ptr;
+            std::shared_ptr<Logical_Device_Wrapper> m_logical_device_wrapper_ptr;
+            std::shared_ptr<Queue_Manager> m_queue_manager_ptr;
+            std::shared_ptr<Storage_Manager> m_storage_manager_ptr;
+            std::shared_ptr<Synchronization_Manager> m_synchronization_manager_ptr;
+
+        private:
+            uint64_t Get_Completed_Timeline_Value();
+            void Wait_For_Timeline_Value(uint64_t timeline_value);
+            uint32_t Begin_Transfer_Command_Buffer(Queue_Manager::Queue_Types queue_type);
+            uint64_t Submit_Transfer_Command_Buffer(uint32_t transfer_command_buffer_index, VkSemaphore wait_semaphore, uint64_t wait_value, VkPipelineStageFlags wait_stage_flags);
+            void Release_Completed_Staging_Regions();
+            VkDeviceSize Allocate_Staging_Region(VkDeviceSize size, uint64_t& region_index);
+            void Submit_Staging_Region(uint64_t region_index, uint64_t timeline_value);
+            void Destroy_Completed_Retired_Buffers();
+
+        public:
+            Transfer_Manager(std::shared_ptr<Command_Buffer_Manager> command_buffer_manager_ptr,
+                             std::shared_ptr<Logical_Device_Wrapper> logical_device_wrapper_ptr,
+                             std::shared_ptr<Queue_Manager> queue_manager_ptr,
+                             std::shared_ptr<Storage_Manager> storage_manager_ptr,
+                             std::shared_ptr<Synchronization_Manager> synchronization_manager_ptr,
+                             std::mutex* vulkan_objects_access_mutex_ptr,
+                             VkDeviceSize staging_buffer_size = 64 * 1024 * 1024);
+            ~Transfer_Manager();
+
+        public:
+            // Takes the Vulkan objects mutex only while recording and submitting, so callers must not hold it. The values behind wait_value_ptr and transfer_ticket_ptr are guarded by that mutex,
+            // each submission waits for the value read when it is submitted and publishes its ticket before the mutex is released. Uploads to different buffers can stage at the same time
+            uint64_t Upload_To_Buffer(Identifier identifier,
+                                      const void* data,
+                                      size_t data_size,
+                                      Queue_Manager::Queue_Types destination_queue_type,
+                                      VkSemaphore wait_semaphore = VK_NULL_HANDLE,
+                                      const uint64_t* wait_value_ptr = nullptr,
+                                      uint64_t* transfer_ticket_ptr = nullptr);
+            uint64_t Upload_To_Buffer(Identifier identifier,
+                                      size_t element_size,
+                                      size_t first_element,
+                                      size_t element_count,
+                                      std::function<void(void*, size_t, size_t)> write_elements_function,
+                                      Queue_Manager::Queue_Types destination_queue_type,
+                                      VkSemaphore wait_semaphore = VK_NULL_HANDLE,
+                                      const uint64_t* wait_value_ptr = nullptr,
+                                      uint64_t* transfer_ticket_ptr = nullptr);
+            // Waits for the copy to finish, so it is meant for small read backs such as counters
+            void Download_From_Buffer(Identifier identifier, void* data, size_t data_size, VkDeviceSize buffer_offset = 0);
+            // Callers must hold the Vulkan objects mutex
+            uint64_t Copy_Buffer(Identifier source_identifier,
+                                 Identifier destination_identifier,
+                                 VkDeviceSize source_offset,
+                                 VkDeviceSize destination_offset,
+                                 VkDeviceSize copy_size,
+                                 VkSemaphore wait_semaphore = VK_NULL_HANDLE,
+                                 uint64_t wait_value = 0);
+            // Callers must hold the Vulkan objects mutex and point their descriptors at the new buffer before releasing it
+            uint64_t Grow_Buffer(Identifier identifier, VkDeviceSize minimum_size, VkSemaphore wait_semaphore = VK_NULL_HANDLE, uint64_t wait_value = 0);
+
+            bool Is_Transfer_Complete(uint64_t transfer_ticket);
+            void Wait_For_Transfer(uint64_t transfer_ticket);
+
+            VkSemaphore* Get_Timeline_Semaphore();
+        };
+    } // namespace Vulkan_Backend
+} // namespace Cascade_Graphics
\ No newline at end of file
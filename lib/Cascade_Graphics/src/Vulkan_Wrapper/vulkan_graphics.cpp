@@ -27,6 +27,8 @@ namespace Cascade_Graphics
             m_pipeline_manager_ptr = std::make_shared<Pipeline_Manager>(m_descriptor_set_manager_ptr, m_logical_device_wrapper_ptr, m_shader_manager_ptr, m_storage_manager_ptr);
             m_command_buffer_manager_ptr = std::make_shared<Command_Buffer_Manager>(m_descriptor_set_manager_ptr, m_logical_device_wrapper_ptr, m_pipeline_manager_ptr, m_storage_manager_ptr);
             m_synchronization_manager_ptr = std::make_shared<Synchronization_Manager>(m_logical_device_wrapper_ptr);
+            m_query_manager_ptr = std::make_shared<Query_Manager>(m_logical_device_wrapper_ptr, m_physical_device_wrapper_ptr);
+            m_transfer_manager_ptr = std::make_shared<Transfer_Manager>(m_command_buffer_manager_ptr, m_logical_device_wrapper_ptr, m_queue_manager_ptr, m_storage_manager_ptr, m_synchronization_manager_ptr, &m_vulkan_objects_access_mutex);
 
             m_is_vulkan_initialized = true;
             m_vulkan_object_access_notify.notify_all();
@@ -44,6 +46,8 @@ namespace Cascade_Graphics
             {
                 VALIDATE_VKRESULT(vkDeviceWaitIdle(*m_logical_device_wrapper_ptr->Get_Device()), "Failed to wait for idle device");
 
+                m_transfer_manager_ptr.reset();
+                m_query_manager_ptr.reset();
                 m_synchronization_manager_ptr.reset();
                 m_command_buffer_manager_ptr.reset();
                 m_pipeline_manager_ptr.reset();
@@ -8,10 +8,12 @@
 #include "logical_device_wrapper.hpp"
 #include "physical_device_wrapper.hpp"
 #include "pipeline_manager.hpp"
+#include "query_manager.hpp"
 #include "queue_manager.hpp"
 #include "shader_manager.hpp"
 #include "storage_manager.hpp"
 #include "synchronization_manager.hpp"
+#include "transfer_manager.hpp"
 #include "validation_layer_wrapper.hpp"
 #include <condition_variable>
 #include <memory>
@@ -43,10 +45,12 @@ namespace Cascade_Graphics
             std::shared_ptr<Logical_Device_Wrapper> m_logical_device_wrapper_ptr;
             std::shared_ptr<Physical_Device_Wrapper> m_physical_device_wrapper_ptr;
             std::shared_ptr<Pipeline_Manager> m_pipeline_manager_ptr;
+            std::shared_ptr<Query_Manager> m_query_manager_ptr;
             std::shared_ptr<Queue_Manager> m_queue_manager_ptr;
             std::shared_ptr<Shader_Manager> m_shader_manager_ptr;
             std::shared_ptr<Storage_Manager> m_storage_manager_ptr;
             std::shared_ptr<Synchronization_Manager> m_synchronization_manager_ptr;
+            std::shared_ptr<Transfer_Manager> m_transfer_manager_ptr;
             std::shared_ptr<Validation_Layer_Wrapper> m_validation_layer_manager_ptr;
 
         public:
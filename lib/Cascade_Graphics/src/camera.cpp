@@ -51,6 +51,18 @@ namespace Cascade_Graphics
         return m_camera_to_world_matrix;
     }
 
+    Vector_3<double> Camera::Get_Ray_Direction(double screen_x, double screen_y, uint32_t screen_width, uint32_t screen_height)
+    {
+        double u = (2.0 * (screen_x + 0.5) - static_cast<double>(screen_width)) / static_cast<double>(screen_height);
+        double v = (2.0 * (screen_y + 0.5) - static_cast<double>(screen_height)) / static_cast<double>(screen_height);
+
+        Vector_3<double> cu = Vector_3<double>(m_camera_to_world_matrix.m_x0, m_camera_to_world_matrix.m_y0, m_camera_to_world_matrix.m_z0);
+        Vector_3<double> cv = Vector_3<double>(m_camera_to_world_matrix.m_x1, m_camera_to_world_matrix.m_y1, m_camera_to_world_matrix.m_z1);
+        Vector_3<double> cw = Vector_3<double>(m_camera_to_world_matrix.m_x2, m_camera_to_world_matrix.m_y2, m_camera_to_world_matrix.m_z2);
+
+        return (cu * u - cv * v + cw).Normalized();
+    }
+
     Camera::GPU_Camera_Data Camera::Get_GPU_Camera_Data(uint32_t which_hit_buffer)
     {
         GPU_Camera_Data camera_data = {};
@@ -28,9 +28,33 @@ namespace Cascade_Graphics
 
             uint32_t which_hit_buffer;
 
+            uint32_t beam_prepass_enabled;
+            uint32_t depth_buffer_index;
+            uint32_t reprojection_enabled;
+
+            float previous_matrix_x0;
+            float previous_matrix_x1;
+            float previous_matrix_x2;
+            float previous_matrix_y0;
+            float previous_matrix_y1;
+            float previous_matrix_y2;
+            float previous_matrix_z0;
+            float previous_matrix_z1;
+            float previous_matrix_z2;
+
+            float previous_origin_x;
+            float previous_origin_y;
+            float previous_origin_z;
+
+            uint32_t render_width;
+            uint32_t render_height;
+            uint32_t previous_render_width;
+            uint32_t previous_render_height;
+
+            uint32_t debug_view;
+            uint32_t statistics_enabled;
             uint32_t padding_a;
             uint32_t padding_b;
-            uint32_t padding_c;
         };
 
     private:
@@ -52,6 +76,7 @@ namespace Cascade_Graphics
 
         Vector_3<double> Get_Camera_Position();
         Matrix_3x3<double> Get_Camera_To_World_Matrix();
+        Vector_3<double> Get_Ray_Direction(double screen_x, double screen_y, uint32_t screen_width, uint32_t screen_height);
         GPU_Camera_Data Get_GPU_Camera_Data(uint32_t which_hit_buffer);
     };
 } // namespace Cascade_Graphics
\ No newline at end of file
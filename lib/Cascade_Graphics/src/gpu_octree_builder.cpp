@@ -0,0 +1,374 @@
+#include "gpu_octree_builder.hpp"
+
+#include "Vulkan_Wrapper/debug_tools.hpp"
+#include "renderer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <vector>
+
+
+namespace Cascade_Graphics
+{
+    GPU_Octree_Builder::GPU_Octree_Builder(std::shared_ptr<Vulkan_Backend::Vulkan_Graphics> vulkan_graphics_ptr, std::shared_ptr<Object_Manager> object_manager_ptr, Renderer* renderer_ptr)
+        : m_vulkan_graphics_ptr(vulkan_graphics_ptr), m_object_manager_ptr(object_manager_ptr), m_renderer_ptr(renderer_ptr)
+    {
+    }
+
+    void GPU_Octree_Builder::Submit_Build_Commands(Vulkan_Backend::Identifier command_buffer_identifier, VkFence build_fence)
+    {
+        // Called with the Vulkan objects mutex held, the compute queue is shared with the renderer
+        m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->End_Recording(command_buffer_identifier);
+
+        VkSubmitInfo submit_info = {};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.pNext = nullptr;
+        submit_info.waitSemaphoreCount = 0;
+        submit_info.pWaitSemaphores = nullptr;
+        submit_info.pWaitDstStageMask = nullptr;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Get_Command_Buffer(command_buffer_identifier);
+        submit_info.signalSemaphoreCount = 0;
+        submit_info.pSignalSemaphores = nullptr;
+
+        VALIDATE_VKRESULT(vkResetFences(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device(), 1, &build_fence), "Graphics: Failed to reset fence");
+        VALIDATE_VKRESULT(vkQueueSubmit(*m_vulkan_graphics_ptr->m_queue_manager_ptr->Get_Queue(Vulkan_Backend::Queue_Manager::Queue_Types::COMPUTE_QUEUE), 1, &submit_info, build_fence), "Graphics: Failed to submit octree build command buffer");
+    }
+
+    void GPU_Octree_Builder::Wait_For_Build_Commands(VkFence build_fence)
+    {
+        // Waited for without the Vulkan objects mutex, so frames keep being rendered while the build runs
+        VALIDATE_VKRESULT(vkWaitForFences(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device(), 1, &build_fence, VK_TRUE, UINT64_MAX), "Graphics: Failed to wait for fence");
+    }
+
+    void GPU_Octree_Builder::Run_Build_Pass(Vulkan_Backend::Identifier command_buffer_identifier,
+                                            Vulkan_Backend::Identifier pipeline_identifier,
+                                            Vulkan_Backend::Identifier build_parameters_identifier,
+                                            const GPU_Build_Parameters& build_parameters,
+                                            VkFence build_fence,
+                                            uint32_t invocation_count)
+    {
+        // Workgroups are spread over y so large passes stay under the 65535 group limit
+        uint32_t group_count = (invocation_count + 63) / 64;
+        uint32_t group_count_y = (group_count + 32767) / 32768;
+        uint32_t group_count_x = (group_count + group_count_y - 1) / group_count_y;
+
+        {
+            std::lock_guard<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Reset_Command_Buffer(command_buffer_identifier);
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Begin_Recording(command_buffer_identifier, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+            // The parameters are recorded with the pass, so the buffer holding them stays in device-local memory
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Update_Buffer(command_buffer_identifier, build_parameters_identifier, &build_parameters, sizeof(GPU_Build_Parameters));
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Memory_Barrier(command_buffer_identifier, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_UNIFORM_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Bind_Compute_Pipeline(command_buffer_identifier, pipeline_identifier);
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Dispatch_Compute_Shader(command_buffer_identifier, group_count_x, group_count_y, 1);
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Memory_Barrier(command_buffer_identifier, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT,
+                                                                                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+            Submit_Build_Commands(command_buffer_identifier, build_fence);
+        }
+
+        Wait_For_Build_Commands(build_fence);
+    }
+
+    std::vector<std::array<int64_t, 5>> GPU_Octree_Builder::Get_Voxel_Keys(const std::vector<Object_Manager::GPU_Voxel>& voxels, Vector_3<double> sample_region_center, double sample_region_size)
+    {
+        // A key is the voxel's depth, its cell in the lattice of that depth and whether it is a leaf
+        Vector_3<double> region_min = sample_region_center - sample_region_size;
+
+        std::vector<std::array<int64_t, 5>> voxel_keys(voxels.size());
+        for (uint32_t i = 0; i < voxels.size(); i++)
+        {
+            const Object_Manager::GPU_Voxel& voxel = voxels[i];
+
+            bool is_leaf = true;
+            for (uint32_t j = 0; j < 8; j++)
+            {
+                is_leaf = is_leaf && voxel.hit_links[j] == (uint32_t)-1;
+            }
+
+            voxel_keys[i][0] = std::llround(std::log2(sample_region_size / voxel.size));
+            voxel_keys[i][1] = std::llround((voxel.position_x - voxel.size - region_min.m_x) / (voxel.size * 2.0));
+            voxel_keys[i][2] = std::llround((voxel.position_y - voxel.size - region_min.m_y) / (voxel.size * 2.0));
+            voxel_keys[i][3] = std::llround((voxel.position_z - voxel.size - region_min.m_z) / (voxel.size * 2.0));
+            voxel_keys[i][4] = is_leaf;
+        }
+        std::sort(voxel_keys.begin(), voxel_keys.end());
+
+        return voxel_keys;
+    }
+
+    GPU_Octree_Builder::GPU_Build_Result GPU_Octree_Builder::Build_GPU_Voxels(std::string label,
+                                                                              uint32_t max_depth,
+                                                                              Vector_3<double> sample_region_center,
+                                                                              double sample_region_size,
+                                                                              std::string volume_functions_source,
+                                                                              uint32_t max_voxel_count,
+                                                                              uint32_t link_offset)
+    {
+        // Sample passes index a child's lattice slices with 32 bit integers
+        if (max_depth > 16)
+        {
+            LOG_ERROR << "Graphics: Object '" << label << "' has a depth of " << max_depth << ", the GPU octree builder supports at most 16";
+            exit(EXIT_FAILURE);
+        }
+
+        // The voxel buffer is sized up front, a size of 0 would otherwise ask the storage manager for the whole heap budget
+        if (max_voxel_count == 0)
+        {
+            LOG_ERROR << "Graphics: Object '" << label << "' needs a voxel budget to be built on the GPU";
+            exit(EXIT_FAILURE);
+        }
+
+        VkPhysicalDeviceProperties physical_device_properties;
+        vkGetPhysicalDeviceProperties(*m_vulkan_graphics_ptr->m_physical_device_wrapper_ptr->Get_Physical_Device(), &physical_device_properties);
+
+        VkDeviceSize voxel_buffer_size = static_cast<VkDeviceSize>(sizeof(Object_Manager::GPU_Voxel)) * max_voxel_count;
+        if (voxel_buffer_size > physical_device_properties.limits.maxStorageBufferRange)
+        {
+            LOG_ERROR << "Graphics: Object '" << label << "' needs " << voxel_buffer_size << " bytes for " << max_voxel_count << " voxels, which is more than the device's storage buffer range of " << physical_device_properties.limits.maxStorageBufferRange
+                      << " bytes";
+            exit(EXIT_FAILURE);
+        }
+
+        // The scratch buffers are only touched by the GPU, the counters are read back through the transfer manager's staging ring
+        Vulkan_Backend::Identifier build_parameters_identifier;
+        Vulkan_Backend::Identifier build_voxels_identifier;
+        Vulkan_Backend::Identifier build_counters_identifier;
+        Vulkan_Backend::Identifier build_child_states_identifier;
+        Vulkan_Backend::Identifier resource_grouping_identifier;
+        Vulkan_Backend::Identifier descriptor_set_identifier;
+        Vulkan_Backend::Identifier sample_shader_identifier;
+        Vulkan_Backend::Identifier build_shader_identifier;
+        Vulkan_Backend::Identifier sample_pipeline_identifier;
+        Vulkan_Backend::Identifier build_pipeline_identifier;
+        Vulkan_Backend::Identifier command_buffer_identifier;
+        Vulkan_Backend::Identifier build_fence_identifier;
+        VkFence build_fence;
+        {
+            std::lock_guard<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+
+            build_parameters_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("octree_build_parameters", sizeof(GPU_Build_Parameters), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                                                                      VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE);
+            build_voxels_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("octree_build_voxels", voxel_buffer_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                                                                  VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                                                                                  Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE | Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
+            build_counters_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("octree_build_counters", sizeof(GPU_Build_Counters), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                                                                    VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                                                                                    Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE | Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
+            build_child_states_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("octree_build_child_states", sizeof(uint32_t) * 8 * max_voxel_count, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                                                                        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE);
+
+            resource_grouping_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Resource_Grouping(
+                "octree_build_resource_grouping", {build_parameters_identifier, build_voxels_identifier, build_counters_identifier, build_child_states_identifier});
+            descriptor_set_identifier = m_vulkan_graphics_ptr->m_descriptor_set_manager_ptr->Create_Descriptor_Set(resource_grouping_identifier);
+            sample_shader_identifier = m_vulkan_graphics_ptr->m_shader_manager_ptr->Add_Shader("octree_sample_shader", "../lib/Cascade_Graphics/src/Shaders/octree_sample.comp", volume_functions_source);
+            build_shader_identifier = m_vulkan_graphics_ptr->m_shader_manager_ptr->Add_Shader("octree_build_shader", "../lib/Cascade_Graphics/src/Shaders/octree_build.comp", volume_functions_source);
+            sample_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("octree_sample_pipeline", descriptor_set_identifier, sample_shader_identifier);
+            build_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("octree_build_pipeline", descriptor_set_identifier, build_shader_identifier);
+            command_buffer_identifier = m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Add_Command_Buffer(
+                "octree_build_command_buffer", m_vulkan_graphics_ptr->m_queue_manager_ptr->Get_Queue_Family_Index(Vulkan_Backend::Queue_Manager::Queue_Types::COMPUTE_QUEUE), {resource_grouping_identifier}, build_pipeline_identifier);
+            build_fence_identifier = m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Create_Fence("octree_build_fence");
+            build_fence = *m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Fence(build_fence_identifier);
+        }
+
+        Object_Manager::GPU_Voxel root_voxel = {};
+        root_voxel.position_x = static_cast<float>(sample_region_center.m_x);
+        root_voxel.position_y = static_cast<float>(sample_region_center.m_y);
+        root_voxel.position_z = static_cast<float>(sample_region_center.m_z);
+        root_voxel.size = static_cast<float>(sample_region_size);
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            root_voxel.hit_links[i] = -1;
+            root_voxel.miss_links[i] = -1;
+        }
+        root_voxel.normal_y = 1.0f;
+
+        GPU_Build_Counters build_counters = {};
+        build_counters.voxel_count = 1;
+        build_counters.overflow = 0;
+
+        {
+            std::lock_guard<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Reset_Command_Buffer(command_buffer_identifier);
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Begin_Recording(command_buffer_identifier, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Update_Buffer(command_buffer_identifier, build_voxels_identifier, &root_voxel, sizeof(Object_Manager::GPU_Voxel));
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Update_Buffer(command_buffer_identifier, build_counters_identifier, &build_counters, sizeof(GPU_Build_Counters));
+
+            // The build pass clears each child state after reading it, so this only has to be done once
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Fill_Buffer(command_buffer_identifier, build_child_states_identifier, 0);
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Memory_Barrier(command_buffer_identifier, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                                                                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+            Submit_Build_Commands(command_buffer_identifier, build_fence);
+        }
+        Wait_For_Build_Commands(build_fence);
+
+        // Each level is split in two passes, the sample pass spreads every child's lattice over its own invocations and the build pass reduces the results into child voxels
+        static const uint64_t SAMPLES_PER_PASS = 1 << 22;
+
+        GPU_Build_Result build_result = {};
+        build_result.voxels_identifier = build_voxels_identifier;
+        build_result.effective_depth = 0;
+        build_result.overflow = false;
+
+        uint32_t level_start = 0;
+        uint32_t level_count = 1;
+        for (uint32_t depth = 0; depth < max_depth && level_count != 0; depth++)
+        {
+            uint32_t step_count = (1u << (max_depth - depth - 1)) + 1;
+            uint64_t slice_sample_count = static_cast<uint64_t>(step_count) * step_count;
+            uint64_t child_sample_count = slice_sample_count * step_count;
+            uint32_t level_child_count = level_count * 8;
+
+            // Small lattices are batched several children per pass, large ones are split into x-slices so no single submission runs long enough to trip the watchdog
+            uint32_t children_per_pass = child_sample_count <= SAMPLES_PER_PASS ? static_cast<uint32_t>(SAMPLES_PER_PASS / child_sample_count) : 1;
+            uint32_t slices_per_pass = child_sample_count <= SAMPLES_PER_PASS ? step_count : static_cast<uint32_t>(std::max<uint64_t>(1, SAMPLES_PER_PASS / slice_sample_count));
+
+            GPU_Build_Parameters build_parameters = {};
+            build_parameters.level_start = level_start;
+            build_parameters.level_count = level_count;
+            build_parameters.max_voxel_count = max_voxel_count;
+            build_parameters.step_count = step_count;
+            build_parameters.step_size = static_cast<float>((sample_region_size * 2.0) / (1 << max_depth));
+            build_parameters.link_offset = link_offset;
+
+            for (uint32_t first_child = 0; first_child < level_child_count; first_child += children_per_pass)
+            {
+                for (uint32_t first_slice = 0; first_slice < step_count; first_slice += slices_per_pass)
+                {
+                    build_parameters.first_child = first_child;
+                    build_parameters.child_count = std::min(children_per_pass, level_child_count - first_child);
+                    build_parameters.first_slice = first_slice;
+                    build_parameters.slice_count = std::min(slices_per_pass, step_count - first_slice);
+
+                    Run_Build_Pass(command_buffer_identifier, sample_pipeline_identifier, build_parameters_identifier, build_parameters, build_fence, static_cast<uint32_t>(slice_sample_count * build_parameters.child_count * build_parameters.slice_count));
+                }
+            }
+
+            Run_Build_Pass(command_buffer_identifier, build_pipeline_identifier, build_parameters_identifier, build_parameters, build_fence, level_count);
+
+            m_vulkan_graphics_ptr->m_transfer_manager_ptr->Download_From_Buffer(build_counters_identifier, &build_counters, sizeof(GPU_Build_Counters));
+
+            // The counter keeps counting past the budget, so an overflowing build stops with the voxels that fit
+            if (build_counters.overflow != 0)
+            {
+                build_counters.voxel_count = max_voxel_count;
+                build_result.overflow = true;
+                break;
+            }
+
+            level_start += level_count;
+            level_count = build_counters.voxel_count - level_start;
+            build_result.effective_depth += level_count != 0 ? 1 : 0;
+
+            LOG_TRACE << "Graphics: Built level " << depth + 1 << " of " << label << " with " << level_count << " voxels";
+        }
+
+        build_result.voxel_count = build_counters.voxel_count;
+
+        std::lock_guard<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+
+        m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Destroy_Fence(build_fence_identifier);
+        m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Remove_Command_Buffer(command_buffer_identifier);
+        m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(build_pipeline_identifier);
+        m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(sample_pipeline_identifier);
+        m_vulkan_graphics_ptr->m_shader_manager_ptr->Remove_Shader(build_shader_identifier);
+        m_vulkan_graphics_ptr->m_shader_manager_ptr->Remove_Shader(sample_shader_identifier);
+        m_vulkan_graphics_ptr->m_descriptor_set_manager_ptr->Remove_Descriptor_Set(descriptor_set_identifier);
+        m_vulkan_graphics_ptr->m_storage_manager_ptr->Remove_Resource_Grouping(resource_grouping_identifier);
+        m_vulkan_graphics_ptr->m_storage_manager_ptr->Destroy_Buffer(build_child_states_identifier);
+        m_vulkan_graphics_ptr->m_storage_manager_ptr->Destroy_Buffer(build_counters_identifier);
+        m_vulkan_graphics_ptr->m_storage_manager_ptr->Destroy_Buffer(build_parameters_identifier);
+
+        // The voxels are left for the caller to copy out
+        return build_result;
+    }
+
+    void GPU_Octree_Builder::Destroy_GPU_Voxels(Vulkan_Backend::Identifier voxels_identifier)
+    {
+        std::lock_guard<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+
+        m_vulkan_graphics_ptr->m_storage_manager_ptr->Destroy_Buffer(voxels_identifier);
+    }
+
+    void GPU_Octree_Builder::Create_Object_From_GLSL_Volume_Function(std::string label,
+                                                                     uint32_t max_depth,
+                                                                     Vector_3<double> sample_region_center,
+                                                                     double sample_region_size,
+                                                                     std::string volume_functions_source,
+                                                                     uint32_t max_voxel_count)
+    {
+        std::chrono::time_point<std::chrono::high_resolution_clock> start_time = std::chrono::high_resolution_clock::now();
+
+        LOG_INFO << "Graphics: Creating object with label '" << label << "' on the GPU";
+
+        // The links are offset by the object's place in the voxel buffer while building, so the voxels can be copied there unchanged
+        uint32_t root_voxel_index = static_cast<uint32_t>(m_object_manager_ptr->Get_GPU_Voxel_Count());
+
+        GPU_Build_Result build_result = Build_GPU_Voxels(label, max_depth, sample_region_center, sample_region_size, volume_functions_source, max_voxel_count, root_voxel_index);
+        if (build_result.overflow)
+        {
+            LOG_ERROR << "Graphics: Object '" << label << "' needs more than the " << max_voxel_count << " voxels reserved for it";
+            exit(EXIT_FAILURE);
+        }
+
+        uint64_t transfer_ticket = m_renderer_ptr->Copy_Voxels_From_Buffer(build_result.voxels_identifier, root_voxel_index, build_result.voxel_count);
+
+        // The root voxel holds its bounds narrowed to float, the same as the copy the GPU traverses
+        Vector_3<double> root_position(static_cast<float>(sample_region_center.m_x), static_cast<float>(sample_region_center.m_y), static_cast<float>(sample_region_center.m_z));
+        m_object_manager_ptr->Create_Object_From_GPU_Voxel_Range(label, root_voxel_index, build_result.voxel_count, root_position, static_cast<float>(sample_region_size), build_result.effective_depth);
+
+        m_vulkan_graphics_ptr->m_transfer_manager_ptr->Wait_For_Transfer(transfer_ticket);
+        Destroy_GPU_Voxels(build_result.voxels_identifier);
+
+        LOG_TRACE << "Graphics: It took " << (float)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count() / 1000.0 << " seconds to generate " << label << " on the GPU";
+    }
+
+    bool GPU_Octree_Builder::Validate_Against_CPU_Builder(uint32_t max_depth, Vector_3<double> sample_region_center, double sample_region_size, const SDF_Graph& sdf_graph, uint32_t max_voxel_count)
+    {
+        LOG_INFO << "Graphics: Validating the GPU octree builder against the CPU builder";
+
+        std::string volume_functions_source = sdf_graph.Emit_GLSL("Sample_Volume") + "\nvec3 Sample_Color(vec3 position, vec3 normal)\n{\n    return vec3(1.0);\n}\n";
+        GPU_Build_Result build_result = Build_GPU_Voxels("gpu_builder_validation", max_depth, sample_region_center, sample_region_size, volume_functions_source, max_voxel_count, 0);
+        if (build_result.overflow)
+        {
+            Destroy_GPU_Voxels(build_result.voxels_identifier);
+
+            LOG_WARN << "Graphics: The GPU builder needed more than the " << max_voxel_count << " voxels reserved for the validation tree";
+            return false;
+        }
+
+        std::vector<Object_Manager::GPU_Voxel> gpu_built_voxels(build_result.voxel_count);
+        m_vulkan_graphics_ptr->m_transfer_manager_ptr->Download_From_Buffer(build_result.voxels_identifier, gpu_built_voxels.data(), sizeof(Object_Manager::GPU_Voxel) * gpu_built_voxels.size());
+        Destroy_GPU_Voxels(build_result.voxels_identifier);
+
+        // A separate object manager keeps the reference tree out of the scene, without a plane error tolerance or budget it subdivides by the same rule as the GPU
+        Object_Manager reference_object_manager;
+        reference_object_manager.Create_Object_From_SDF_Graph(
+            "gpu_builder_validation", max_depth, sample_region_center, sample_region_size, sdf_graph, [](Vector_3<double>, Vector_3<double>) { return Vector_3<double>(1.0, 1.0, 1.0); }, 0.0, 0);
+        std::vector<Object_Manager::GPU_Voxel> cpu_built_voxels(reference_object_manager.Get_GPU_Voxel_Count());
+        reference_object_manager.Write_GPU_Voxels(cpu_built_voxels.data(), 0, cpu_built_voxels.size());
+
+        // The builders emit voxels in different orders, so both trees are compared as sorted sets of voxel keys
+        std::vector<std::array<int64_t, 5>> gpu_voxel_keys = Get_Voxel_Keys(gpu_built_voxels, sample_region_center, sample_region_size);
+        std::vector<std::array<int64_t, 5>> cpu_voxel_keys = Get_Voxel_Keys(cpu_built_voxels, sample_region_center, sample_region_size);
+
+        std::vector<std::array<int64_t, 5>> mismatched_voxel_keys;
+        std::set_symmetric_difference(gpu_voxel_keys.begin(), gpu_voxel_keys.end(), cpu_voxel_keys.begin(), cpu_voxel_keys.end(), std::back_inserter(mismatched_voxel_keys));
+
+        if (!mismatched_voxel_keys.empty())
+        {
+            LOG_WARN << "Graphics: The GPU built " << gpu_built_voxels.size() << " voxels and the CPU built " << cpu_built_voxels.size() << ", " << mismatched_voxel_keys.size() << " voxels only appear in one of the trees";
+            return false;
+        }
+
+        LOG_INFO << "Graphics: The GPU and CPU builders produced the same tree of " << gpu_built_voxels.size() << " voxels";
+        return true;
+    }
+} // namespace Cascade_Graphics
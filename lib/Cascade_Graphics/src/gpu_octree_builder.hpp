@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Data_Types/vector_3.hpp"
+#include "Vulkan_Wrapper/identifier.hpp"
+#include "Vulkan_Wrapper/vulkan_graphics.hpp"
+#include "object_manager.hpp"
+#include "sdf_graph.hpp"
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace Cascade_Graphics
+{
+    class Renderer;
+
+    class GPU_Octree_Builder
+    {
+    private:
+        struct GPU_Build_Parameters
+        {
+            uint32_t level_start;
+            uint32_t level_count;
+            uint32_t max_voxel_count;
+            uint32_t step_count;
+            float step_size;
+
+            uint32_t first_child;
+            uint32_t child_count;
+            uint32_t first_slice;
+            uint32_t slice_count;
+
+            uint32_t link_offset;
+            uint32_t padding_b;
+            uint32_t padding_c;
+        };
+
+        struct GPU_Build_Counters
+        {
+            uint32_t voxel_count;
+            uint32_t overflow;
+        };
+
+        struct GPU_Build_Result
+        {
+            Vulkan_Backend::Identifier voxels_identifier;
+            uint32_t voxel_count;
+            uint32_t effective_depth;
+            bool overflow;
+        };
+
+    private:
+        std::shared_ptr<Vulkan_Backend::Vulkan_Graphics> m_vulkan_graphics_ptr;
+        std::shared_ptr<Object_Manager> m_object_manager_ptr;
+        Renderer* m_renderer_ptr;
+
+    private:
+        static std::vector<std::array<int64_t, 5>> Get_Voxel_Keys(const std::vector<Object_Manager::GPU_Voxel>& voxels, Vector_3<double> sample_region_center, double sample_region_size);
+
+        void Submit_Build_Commands(Vulkan_Backend::Identifier command_buffer_identifier, VkFence build_fence);
+        void Wait_For_Build_Commands(VkFence build_fence);
+        void Run_Build_Pass(Vulkan_Backend::Identifier command_buffer_identifier,
+                            Vulkan_Backend::Identifier pipeline_identifier,
+                            Vulkan_Backend::Identifier build_parameters_identifier,
+                            const GPU_Build_Parameters& build_parameters,
+                            VkFence build_fence,
+                            uint32_t invocation_count);
+        GPU_Build_Result Build_GPU_Voxels(std::string label, uint32_t max_depth, Vector_3<double> sample_region_center, double sample_region_size, std::string volume_functions_source, uint32_t max_voxel_count, uint32_t link_offset);
+        void Destroy_GPU_Voxels(Vulkan_Backend::Identifier voxels_identifier);
+
+    public:
+        GPU_Octree_Builder(std::shared_ptr<Vulkan_Backend::Vulkan_Graphics> vulkan_graphics_ptr, std::shared_ptr<Object_Manager> object_manager_ptr, Renderer* renderer_ptr);
+
+    public:
+        void Create_Object_From_GLSL_Volume_Function(std::string label, uint32_t max_depth, Vector_3<double> sample_region_center, double sample_region_size, std::string volume_functions_source, uint32_t max_voxel_count);
+        bool Validate_Against_CPU_Builder(uint32_t max_depth, Vector_3<double> sample_region_center, double sample_region_size, const SDF_Graph& sdf_graph, uint32_t max_voxel_count);
+    };
+} // namespace Cascade_Graphics
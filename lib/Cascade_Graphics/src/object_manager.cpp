@@ -1,7 +1,10 @@
 #include "object_manager.hpp"
 
 #include "cascade_logging.hpp"
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <limits>
 #include <thread>
 #include <utility>
 
@@ -9,6 +12,284 @@ namespace Cascade_Graphics
 {
     Object_Manager::Object_Manager()
     {
+        // The thread handing out tasks works on them as well, so one worker less than there are hardware threads keeps every core busy
+        uint32_t worker_thread_count = std::max(1u, std::thread::hardware_concurrency()) - 1;
+        for (uint32_t i = 0; i < worker_thread_count; i++)
+        {
+            m_worker_threads.emplace_back(Worker_Loop, this);
+        }
+    }
+
+    Object_Manager::~Object_Manager()
+    {
+        {
+            std::unique_lock<std::mutex> task_queue_lock(m_task_queue_mutex);
+            m_workers_active = false;
+        }
+        m_task_available_notify.notify_all();
+
+        for (uint32_t i = 0; i < m_worker_threads.size(); i++)
+        {
+            m_worker_threads[i].join();
+        }
+    }
+
+    void Object_Manager::Worker_Loop(Object_Manager* instance)
+    {
+        std::unique_lock<std::mutex> task_queue_lock(instance->m_task_queue_mutex);
+        while (true)
+        {
+            instance->m_task_available_notify.wait(task_queue_lock, [&] { return !instance->m_task_queue.empty() || !instance->m_workers_active; });
+            if (instance->m_task_queue.empty())
+            {
+                return;
+            }
+
+            std::function<void()> task = std::move(instance->m_task_queue.front());
+            instance->m_task_queue.pop();
+
+            task_queue_lock.unlock();
+            task();
+            task_queue_lock.lock();
+
+            instance->m_pending_task_count--;
+            if (instance->m_pending_task_count == 0)
+            {
+                instance->m_tasks_complete_notify.notify_all();
+            }
+        }
+    }
+
+    void Object_Manager::Run_Tasks(std::vector<std::function<void()>>& tasks)
+    {
+        std::unique_lock<std::mutex> task_queue_lock(m_task_queue_mutex);
+        for (uint32_t i = 0; i < tasks.size(); i++)
+        {
+            m_task_queue.push(std::move(tasks[i]));
+        }
+        m_pending_task_count += tasks.size();
+        m_task_available_notify.notify_all();
+
+        while (!m_task_queue.empty())
+        {
+            std::function<void()> task = std::move(m_task_queue.front());
+            m_task_queue.pop();
+
+            task_queue_lock.unlock();
+            task();
+            task_queue_lock.lock();
+
+            m_pending_task_count--;
+        }
+
+        m_tasks_complete_notify.wait(task_queue_lock, [&] { return m_pending_task_count == 0; });
+    }
+
+    Object_Manager::Object_Transform Object_Manager::Get_Object_Transform(const Object& object)
+    {
+        if (!std::isfinite(object.position.m_x) || !std::isfinite(object.position.m_y) || !std::isfinite(object.position.m_z) || !std::isfinite(object.rotation.m_x) || !std::isfinite(object.rotation.m_y) || !std::isfinite(object.rotation.m_z)
+            || !std::isfinite(object.scale.m_x) || !std::isfinite(object.scale.m_y) || !std::isfinite(object.scale.m_z))
+        {
+            LOG_ERROR << "Graphics: The transform of object '" << object.label << "' is not finite";
+            exit(EXIT_FAILURE);
+        }
+
+        double sin_yaw = sin(object.rotation.m_x);
+        double cos_yaw = cos(object.rotation.m_x);
+        double sin_pitch = sin(object.rotation.m_y);
+        double cos_pitch = cos(object.rotation.m_y);
+        double sin_roll = sin(object.rotation.m_z);
+        double cos_roll = cos(object.rotation.m_z);
+
+        Object_Transform transform = {};
+        transform.object_to_world[0][0] = object.scale.m_x * (cos_pitch * cos_roll);
+        transform.object_to_world[0][1] = object.scale.m_x * (sin_yaw * sin_pitch * cos_roll - cos_yaw * sin_roll);
+        transform.object_to_world[0][2] = object.scale.m_x * (cos_yaw * sin_pitch * cos_roll + sin_yaw * sin_roll);
+        transform.object_to_world[0][3] = object.position.m_x;
+        transform.object_to_world[1][0] = object.scale.m_y * (cos_pitch * sin_roll);
+        transform.object_to_world[1][1] = object.scale.m_y * (sin_yaw * sin_pitch * sin_roll + cos_yaw * cos_roll);
+        transform.object_to_world[1][2] = object.scale.m_y * (cos_yaw * sin_pitch * sin_roll - sin_yaw * cos_roll);
+        transform.object_to_world[1][3] = object.position.m_y;
+        transform.object_to_world[2][0] = object.scale.m_z * (-sin_pitch);
+        transform.object_to_world[2][1] = object.scale.m_z * (sin_yaw * cos_pitch);
+        transform.object_to_world[2][2] = object.scale.m_z * (cos_yaw * cos_pitch);
+        transform.object_to_world[2][3] = object.position.m_z;
+
+        const double(&m)[3][4] = transform.object_to_world;
+
+        double cofactor_00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+        double cofactor_01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+        double cofactor_02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+
+        double determinant = m[0][0] * cofactor_00 + m[0][1] * cofactor_01 + m[0][2] * cofactor_02;
+
+        // A zero scale is legal, for example while animating an object in or out, and such an object has no volume to hit or overlap
+        transform.is_invertible = determinant != 0.0 && std::isfinite(1.0 / determinant);
+        if (!transform.is_invertible)
+        {
+            return transform;
+        }
+        double inverse_determinant = 1.0 / determinant;
+
+        transform.world_to_object[0][0] = cofactor_00 * inverse_determinant;
+        transform.world_to_object[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * inverse_determinant;
+        transform.world_to_object[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * inverse_determinant;
+        transform.world_to_object[1][0] = cofactor_01 * inverse_determinant;
+        transform.world_to_object[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * inverse_determinant;
+        transform.world_to_object[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * inverse_determinant;
+        transform.world_to_object[2][0] = cofactor_02 * inverse_determinant;
+        transform.world_to_object[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * inverse_determinant;
+        transform.world_to_object[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * inverse_determinant;
+
+        for (uint32_t row = 0; row < 3; row++)
+        {
+            transform.world_to_object[row][3] = -(transform.world_to_object[row][0] * m[0][3] + transform.world_to_object[row][1] * m[1][3] + transform.world_to_object[row][2] * m[2][3]);
+        }
+
+        return transform;
+    }
+
+    Vector_3<double> Object_Manager::Transform_Point(const double matrix[3][4], Vector_3<double> point)
+    {
+        return Vector_3<double>(matrix[0][0] * point.m_x + matrix[0][1] * point.m_y + matrix[0][2] * point.m_z + matrix[0][3], matrix[1][0] * point.m_x + matrix[1][1] * point.m_y + matrix[1][2] * point.m_z + matrix[1][3],
+                                matrix[2][0] * point.m_x + matrix[2][1] * point.m_y + matrix[2][2] * point.m_z + matrix[2][3]);
+    }
+
+    Vector_3<double> Object_Manager::Transform_Direction(const double matrix[3][4], Vector_3<double> direction)
+    {
+        return Vector_3<double>(matrix[0][0] * direction.m_x + matrix[0][1] * direction.m_y + matrix[0][2] * direction.m_z, matrix[1][0] * direction.m_x + matrix[1][1] * direction.m_y + matrix[1][2] * direction.m_z,
+                                matrix[2][0] * direction.m_x + matrix[2][1] * direction.m_y + matrix[2][2] * direction.m_z);
+    }
+
+    bool Object_Manager::Ray_Box_Intersection(Vector_3<double> ray_origin, Vector_3<double> fractional_ray_direction, double box_size, double& distance)
+    {
+        Vector_3<double> t0 = (-ray_origin - box_size) * fractional_ray_direction;
+        Vector_3<double> t1 = (-ray_origin + box_size) * fractional_ray_direction;
+
+        double min_component = std::min(std::min(std::max(t0.m_x, t1.m_x), std::max(t0.m_y, t1.m_y)), std::max(t0.m_z, t1.m_z));
+        double max_component = std::max(std::max(std::min(t0.m_x, t1.m_x), std::min(t0.m_y, t1.m_y)), std::min(t0.m_z, t1.m_z));
+
+        distance = max_component;
+
+        return !(max_component > min_component || min_component < 0.0);
+    }
+
+    Object_Manager::Object_Bounds Object_Manager::Get_Object_World_Bounds(const Object_Transform& transform, const Object& object)
+    {
+        Vector_3<double> center = Transform_Point(transform.object_to_world, object.root_position);
+
+        double extent[3];
+        for (uint32_t row = 0; row < 3; row++)
+        {
+            extent[row] = (std::abs(transform.object_to_world[row][0]) + std::abs(transform.object_to_world[row][1]) + std::abs(transform.object_to_world[row][2])) * object.root_size;
+        }
+
+        Object_Bounds bounds = {};
+        bounds.min = Vector_3<double>(center.m_x - extent[0], center.m_y - extent[1], center.m_z - extent[2]);
+        bounds.max = Vector_3<double>(center.m_x + extent[0], center.m_y + extent[1], center.m_z + extent[2]);
+
+        return bounds;
+    }
+
+    uint32_t Object_Manager::Build_BVH_Node(std::vector<GPU_BVH_Node>& bvh_nodes, std::vector<BVH_Build_Node>& build_nodes, const std::vector<Object_Bounds>& object_bounds, uint32_t* object_indices_ptr, uint32_t object_count)
+    {
+        Object_Bounds node_bounds = object_bounds[object_indices_ptr[0]];
+        Object_Bounds centroid_bounds = {};
+        centroid_bounds.min = Vector_3<double>(std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+        centroid_bounds.max = Vector_3<double>(std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest());
+
+        for (uint32_t i = 0; i < object_count; i++)
+        {
+            const Object_Bounds& bounds = object_bounds[object_indices_ptr[i]];
+
+            node_bounds.min = Vector_3<double>(std::min(node_bounds.min.m_x, bounds.min.m_x), std::min(node_bounds.min.m_y, bounds.min.m_y), std::min(node_bounds.min.m_z, bounds.min.m_z));
+            node_bounds.max = Vector_3<double>(std::max(node_bounds.max.m_x, bounds.max.m_x), std::max(node_bounds.max.m_y, bounds.max.m_y), std::max(node_bounds.max.m_z, bounds.max.m_z));
+
+            Vector_3<double> centroid((bounds.min.m_x + bounds.max.m_x) * 0.5, (bounds.min.m_y + bounds.max.m_y) * 0.5, (bounds.min.m_z + bounds.max.m_z) * 0.5);
+            centroid_bounds.min = Vector_3<double>(std::min(centroid_bounds.min.m_x, centroid.m_x), std::min(centroid_bounds.min.m_y, centroid.m_y), std::min(centroid_bounds.min.m_z, centroid.m_z));
+            centroid_bounds.max = Vector_3<double>(std::max(centroid_bounds.max.m_x, centroid.m_x), std::max(centroid_bounds.max.m_y, centroid.m_y), std::max(centroid_bounds.max.m_z, centroid.m_z));
+        }
+
+        // Round outwards so the float bounds never clip the double precision ones
+        GPU_BVH_Node node = {};
+        node.min_x = std::nextafter(static_cast<float>(node_bounds.min.m_x), -std::numeric_limits<float>::infinity());
+        node.min_y = std::nextafter(static_cast<float>(node_bounds.min.m_y), -std::numeric_limits<float>::infinity());
+        node.min_z = std::nextafter(static_cast<float>(node_bounds.min.m_z), -std::numeric_limits<float>::infinity());
+        node.max_x = std::nextafter(static_cast<float>(node_bounds.max.m_x), std::numeric_limits<float>::infinity());
+        node.max_y = std::nextafter(static_cast<float>(node_bounds.max.m_y), std::numeric_limits<float>::infinity());
+        node.max_z = std::nextafter(static_cast<float>(node_bounds.max.m_z), std::numeric_limits<float>::infinity());
+        node.object_index = -1;
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            node.hit_links[i] = -1;
+            node.miss_links[i] = -1;
+        }
+
+        uint32_t node_index = bvh_nodes.size();
+        bvh_nodes.push_back(node);
+        build_nodes.push_back({static_cast<uint32_t>(-1), 0});
+
+        if (object_count == 1)
+        {
+            bvh_nodes[node_index].object_index = object_indices_ptr[0];
+            return node_index;
+        }
+
+        // Median split along the widest axis of the object centers
+        double centroid_extent[3] = {centroid_bounds.max.m_x - centroid_bounds.min.m_x, centroid_bounds.max.m_y - centroid_bounds.min.m_y, centroid_bounds.max.m_z - centroid_bounds.min.m_z};
+        uint32_t split_axis = 0;
+        if (centroid_extent[1] > centroid_extent[split_axis])
+        {
+            split_axis = 1;
+        }
+        if (centroid_extent[2] > centroid_extent[split_axis])
+        {
+            split_axis = 2;
+        }
+
+        uint32_t left_object_count = object_count / 2;
+        std::nth_element(object_indices_ptr, object_indices_ptr + left_object_count, object_indices_ptr + object_count, [&](uint32_t a, uint32_t b) {
+            const Object_Bounds& bounds_a = object_bounds[a];
+            const Object_Bounds& bounds_b = object_bounds[b];
+
+            switch (split_axis)
+            {
+                case 0:
+                    return bounds_a.min.m_x + bounds_a.max.m_x < bounds_b.min.m_x + bounds_b.max.m_x;
+                case 1:
+                    return bounds_a.min.m_y + bounds_a.max.m_y < bounds_b.min.m_y + bounds_b.max.m_y;
+                default:
+                    return bounds_a.min.m_z + bounds_a.max.m_z < bounds_b.min.m_z + bounds_b.max.m_z;
+            }
+        });
+
+        build_nodes[node_index].split_axis = split_axis;
+
+        Build_BVH_Node(bvh_nodes, build_nodes, object_bounds, object_indices_ptr, left_object_count);
+        uint32_t right_child_index = Build_BVH_Node(bvh_nodes, build_nodes, object_bounds, object_indices_ptr + left_object_count, object_count - left_object_count);
+        build_nodes[node_index].right_child_index = right_child_index;
+
+        return node_index;
+    }
+
+    void Object_Manager::Link_BVH_Node(std::vector<GPU_BVH_Node>& bvh_nodes, const std::vector<BVH_Build_Node>& build_nodes, uint32_t direction_index, uint32_t node_index, uint32_t miss_index)
+    {
+        // Like the voxel links, each ray direction gets its own ordering so the child nearer to the ray origin is visited first
+        bvh_nodes[node_index].miss_links[direction_index] = miss_index;
+
+        if (bvh_nodes[node_index].object_index == static_cast<uint32_t>(-1))
+        {
+            uint32_t near_child_index = node_index + 1;
+            uint32_t far_child_index = build_nodes[node_index].right_child_index;
+            if (direction_index & (1 << build_nodes[node_index].split_axis))
+            {
+                std::swap(near_child_index, far_child_index);
+            }
+
+            bvh_nodes[node_index].hit_links[direction_index] = near_child_index;
+            Link_BVH_Node(bvh_nodes, build_nodes, direction_index, near_child_index, far_child_index);
+            Link_BVH_Node(bvh_nodes, build_nodes, direction_index, far_child_index, miss_index);
+        }
     }
 
     void Object_Manager::Voxel_Sample_Volume_Function(Vector_3<double> voxel_position,
@@ -16,13 +297,73 @@ namespace Cascade_Graphics
                                                       double step_size,
                                                       uint32_t step_count,
                                                       std::function<double(Vector_3<double>)> volume_sample_function,
+                                                      std::function<void(Vector_3<double>, double, double&, double&)> volume_bounds_function,
+                                                      const SDF_Graph* sdf_graph_ptr,
+                                                      std::vector<Vector_3<double>>& sample_positions,
+                                                      std::vector<double>& sample_distances,
+                                                      std::vector<double>& sample_scratch,
                                                       bool& is_fully_contained,
                                                       bool& is_intersecting)
     {
+        if (volume_bounds_function)
+        {
+            // Bounds that don't cross zero give the same answer as sampling the whole lattice
+            double min_distance;
+            double max_distance;
+            volume_bounds_function(voxel_position, voxel_size, min_distance, max_distance);
+
+            if (min_distance >= 0.0)
+            {
+                is_fully_contained = false;
+                is_intersecting = false;
+                return;
+            }
+            if (max_distance < 0.0)
+            {
+                is_fully_contained = true;
+                is_intersecting = true;
+                return;
+            }
+        }
+
         is_fully_contained = true;
         is_intersecting = false;
 
         Vector_3<double> start_position = voxel_position - voxel_size;
+
+        if (sdf_graph_ptr != nullptr)
+        {
+            // Graphs are evaluated one x-slice of the lattice at a time, the per thread buffers are reused for every voxel
+            sample_positions.resize(step_count * step_count);
+
+            for (uint32_t i = 0; i < step_count; i++)
+            {
+                for (uint32_t j = 0; j < step_count; j++)
+                {
+                    for (uint32_t k = 0; k < step_count; k++)
+                    {
+                        sample_positions[j * step_count + k] = start_position + Vector_3<double>(i * step_size, j * step_size, k * step_size);
+                    }
+                }
+
+                sdf_graph_ptr->Evaluate_Batch(sample_positions, sample_distances, sample_scratch);
+
+                for (uint32_t j = 0; j < sample_distances.size(); j++)
+                {
+                    bool sample = sample_distances[j] < 0.0;
+
+                    is_fully_contained = is_fully_contained && sample;
+                    is_intersecting = is_intersecting || sample;
+                }
+
+                if ((!is_fully_contained) && is_intersecting)
+                {
+                    return;
+                }
+            }
+            return;
+        }
+
         Vector_3<double> sample_position = start_position;
 
         bool sample;
@@ -51,14 +392,58 @@ namespace Cascade_Graphics
         }
     }
 
+    bool Object_Manager::Voxel_Within_Plane_Error(Vector_3<double> voxel_position,
+                                                  double voxel_size,
+                                                  Vector_3<double> normal,
+                                                  double plane_offset,
+                                                  double normal_slope,
+                                                  std::function<double(Vector_3<double>)> volume_sample_function,
+                                                  double plane_error_tolerance)
+    {
+        static const uint32_t PLANE_ERROR_SAMPLE_COUNT = 5;
+
+        Vector_3<double> plane_position = voxel_position + normal * plane_offset;
+        Vector_3<double> start_position = voxel_position - voxel_size;
+        double sample_spacing = (voxel_size * 2.0) / (PLANE_ERROR_SAMPLE_COUNT - 1);
+
+        // Compare the field's distance estimate against the distance to the voxel's plane, a leaf renders as that plane
+        for (uint32_t i = 0; i < PLANE_ERROR_SAMPLE_COUNT; i++)
+        {
+            for (uint32_t j = 0; j < PLANE_ERROR_SAMPLE_COUNT; j++)
+            {
+                for (uint32_t k = 0; k < PLANE_ERROR_SAMPLE_COUNT; k++)
+                {
+                    Vector_3<double> sample_position = start_position + Vector_3<double>(i * sample_spacing, j * sample_spacing, k * sample_spacing);
+                    Vector_3<double> plane_to_sample = sample_position - plane_position;
+
+                    double field_distance = -volume_sample_function(sample_position) / normal_slope;
+                    double plane_distance = plane_to_sample.m_x * normal.m_x + plane_to_sample.m_y * normal.m_y + plane_to_sample.m_z * normal.m_z;
+
+                    if (!(std::abs(field_distance - plane_distance) <= plane_error_tolerance))
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
     void Object_Manager::Object_From_Volume_Function_Worker_Thread(uint32_t max_depth,
                                                                    std::vector<uint32_t> step_count_lookup_table,
                                                                    double step_size,
+                                                                   double plane_error_tolerance,
+                                                                   uint32_t max_voxel_count,
                                                                    uint32_t worker_index,
                                                                    std::function<double(Vector_3<double>)> volume_sample_function,
+                                                                   std::function<void(Vector_3<double>, double, double&, double&)> volume_bounds_function,
                                                                    std::function<Vector_3<double>(Vector_3<double>, Vector_3<double>)> color_sample_function,
+                                                                   const SDF_Graph* sdf_graph_ptr,
                                                                    std::vector<Voxel>* voxels_ptr,
                                                                    std::mutex* voxels_mutex_ptr,
+                                                                   uint32_t* reserved_voxel_count_ptr,
+                                                                   uint32_t* truncated_depth_ptr,
                                                                    bool* work_complete_ptr,
                                                                    std::mutex* work_complete_mutex_ptr,
                                                                    uint32_t* active_workers_count_ptr,
@@ -68,6 +453,7 @@ namespace Cascade_Graphics
                                                                    std::stack<uint32_t>* leaf_node_stack_ptr,
                                                                    std::mutex* leaf_node_stack_mutex_ptr,
                                                                    std::condition_variable* available_leaf_node_notify_ptr,
+                                                                   std::vector<uint32_t>* deferred_voxels_ptr,
                                                                    bool* work_available_ptr,
                                                                    uint32_t* current_voxel_ptr,
                                                                    std::mutex* data_mutex_ptr,
@@ -81,6 +467,9 @@ namespace Cascade_Graphics
 
         Voxel current_voxel;
 
+        std::vector<Vector_3<double>> sample_positions;
+        std::vector<double> sample_distances;
+        std::vector<double> sample_scratch;
 
         while (true)
         {
@@ -107,7 +496,28 @@ namespace Cascade_Graphics
                 current_voxel = (*voxels_ptr)[*current_voxel_ptr];
             }
 
-            if (current_voxel.depth != max_depth)
+            bool expand_voxel = current_voxel.depth != max_depth;
+            uint32_t reserved_voxel_count = 0;
+
+            if (expand_voxel && max_voxel_count != 0)
+            {
+                std::lock_guard<std::mutex> voxels_lock(*voxels_mutex_ptr);
+
+                // Reserve room for every child up front so concurrent workers can't overshoot the budget
+                if (voxels_ptr->size() + *reserved_voxel_count_ptr + 8 > max_voxel_count)
+                {
+                    expand_voxel = false;
+                    current_voxel.is_leaf = true;
+                    *truncated_depth_ptr = std::min(*truncated_depth_ptr, current_voxel.depth);
+                }
+                else
+                {
+                    reserved_voxel_count = 8;
+                    *reserved_voxel_count_ptr += reserved_voxel_count;
+                }
+            }
+
+            if (expand_voxel)
             {
                 for (uint32_t i = 0; i < 8; i++)
                 {
@@ -118,7 +528,8 @@ namespace Cascade_Graphics
 
                     bool is_fully_contained;
                     bool is_intersecting;
-                    Voxel_Sample_Volume_Function(child_voxel.position, child_voxel.size, step_size, step_count_lookup_table[child_voxel.depth], volume_sample_function, is_fully_contained, is_intersecting);
+                    Voxel_Sample_Volume_Function(child_voxel.position, child_voxel.size, step_size, step_count_lookup_table[child_voxel.depth], volume_sample_function, volume_bounds_function, sdf_graph_ptr, sample_positions, sample_distances, sample_scratch,
+                                                 is_fully_contained, is_intersecting);
 
                     if (is_intersecting && !is_fully_contained)
                     {
@@ -155,22 +566,38 @@ namespace Cascade_Graphics
                         double z_density = volume_sample_function(child_voxel.position - Vector_3<double>(0.0, 0.0, 0.00001));
                         child_voxel.normal = (Vector_3<double>(center_density, center_density, center_density) - Vector_3<double>(x_density, y_density, z_density)).Normalized();
 
-                        child_voxel.plane_offset = (center_density - volume_sample_function(child_voxel.position + child_voxel.normal * 0.001)) / 0.001;
-                        child_voxel.plane_offset = center_density / child_voxel.plane_offset;
+                        double normal_slope = (center_density - volume_sample_function(child_voxel.position + child_voxel.normal * 0.001)) / 0.001;
+                        child_voxel.plane_offset = center_density / normal_slope;
 
                         child_voxel.color = color_sample_function(child_voxel.position, child_voxel.normal);
                         child_voxel.is_leaf = child_voxel.depth == max_depth || is_fully_contained;
 
+                        if (!child_voxel.is_leaf && plane_error_tolerance > 0.0)
+                        {
+                            child_voxel.is_leaf = Voxel_Within_Plane_Error(child_voxel.position, child_voxel.size, child_voxel.normal, child_voxel.plane_offset, normal_slope, volume_sample_function, plane_error_tolerance);
+                        }
+
                         {
                             std::lock_guard<std::mutex> voxels_lock(*voxels_mutex_ptr);
 
                             current_voxel.child_indices[i] = static_cast<uint32_t>(voxels_ptr->size());
                             voxels_ptr->push_back(child_voxel);
+
+                            if (reserved_voxel_count != 0)
+                            {
+                                reserved_voxel_count--;
+                                (*reserved_voxel_count_ptr)--;
+                            }
                         }
                     }
                     else
                     {
                         current_voxel.child_indices[i] = -1;
+
+                        if (is_fully_contained)
+                        {
+                            current_voxel.solid_child_mask |= 1 << i;
+                        }
                     }
                 }
 
@@ -193,9 +620,10 @@ namespace Cascade_Graphics
                 std::lock_guard<std::mutex> voxels_lock(*voxels_mutex_ptr);
 
                 (*voxels_ptr)[*current_voxel_ptr] = current_voxel;
+                *reserved_voxel_count_ptr -= reserved_voxel_count;
             }
 
-            if (current_voxel.depth != max_depth)
+            if (expand_voxel)
             {
                 std::lock_guard<std::mutex> leaf_node_stack_lock(*leaf_node_stack_mutex_ptr);
                 std::lock_guard<std::mutex> voxels_lock(*voxels_mutex_ptr);
@@ -221,8 +649,15 @@ namespace Cascade_Graphics
 
                         if (!(*voxels_ptr)[current_voxel.child_indices[i]].is_leaf)
                         {
-                            leaf_node_stack_ptr->push(current_voxel.child_indices[i]);
-                            added_leaf_node = true;
+                            if (deferred_voxels_ptr != nullptr)
+                            {
+                                deferred_voxels_ptr->push_back(current_voxel.child_indices[i]);
+                            }
+                            else
+                            {
+                                leaf_node_stack_ptr->push(current_voxel.child_indices[i]);
+                                added_leaf_node = true;
+                            }
                         }
                     }
                 }
@@ -266,11 +701,44 @@ namespace Cascade_Graphics
                                                             double sample_region_size,
                                                             std::function<double(Vector_3<double>)> volume_sample_function,
                                                             std::function<Vector_3<double>(Vector_3<double>, Vector_3<double>)> color_sample_function)
+    {
+        Create_Object_From_Volume_Function(label, max_depth, sample_region_center, sample_region_size, volume_sample_function, nullptr, color_sample_function, 0.0, 0);
+    }
+
+    void Object_Manager::Create_Object_From_Volume_Function(std::string label,
+                                                            uint32_t max_depth,
+                                                            Vector_3<double> sample_region_center,
+                                                            double sample_region_size,
+                                                            std::function<double(Vector_3<double>)> volume_sample_function,
+                                                            std::function<void(Vector_3<double>, double, double&, double&)> volume_bounds_function,
+                                                            std::function<Vector_3<double>(Vector_3<double>, Vector_3<double>)> color_sample_function,
+                                                            double plane_error_tolerance,
+                                                            uint32_t max_voxel_count)
+    {
+        Build_Object_From_Volume_Function(label, max_depth, sample_region_center, sample_region_size, volume_sample_function, volume_bounds_function, color_sample_function, nullptr, plane_error_tolerance, max_voxel_count);
+    }
+
+    void Object_Manager::Build_Object_From_Volume_Function(std::string label,
+                                                           uint32_t max_depth,
+                                                           Vector_3<double> sample_region_center,
+                                                           double sample_region_size,
+                                                           std::function<double(Vector_3<double>)> volume_sample_function,
+                                                           std::function<void(Vector_3<double>, double, double&, double&)> volume_bounds_function,
+                                                           std::function<Vector_3<double>(Vector_3<double>, Vector_3<double>)> color_sample_function,
+                                                           const SDF_Graph* sdf_graph_ptr,
+                                                           double plane_error_tolerance,
+                                                           uint32_t max_voxel_count)
     {
         std::chrono::time_point<std::chrono::high_resolution_clock> start_time = std::chrono::high_resolution_clock::now();
 
         LOG_INFO << "Graphics: Creating object with label '" << label << "'";
 
+        if (max_voxel_count != 0 && max_voxel_count < 9)
+        {
+            LOG_ERROR << "Graphics: The voxel budget for '" << label << "' must leave room for the root voxel and its children";
+            exit(EXIT_FAILURE);
+        }
+
         for (uint32_t i = 0; i < m_objects.size(); i++)
         {
             if (m_objects[i].label == label)
@@ -285,6 +753,7 @@ namespace Cascade_Graphics
         m_objects.back().label = label;
         m_objects.back().position = Vector_3<double>(0.0, 0.0, 0.0);
         m_objects.back().scale = Vector_3<double>(1.0, 1.0, 1.0);
+        m_objects.back().voxel_retention_policy = RETAIN_FULL_VOXELS;
 
         Voxel root_voxel = {};
         root_voxel.size = sample_region_size;
@@ -318,6 +787,7 @@ namespace Cascade_Graphics
         root_voxel.miss_links[7] = -1;
         root_voxel.depth = 0;
         root_voxel.is_leaf = false;
+        root_voxel.solid_child_mask = 0;
 
         m_objects.back().voxels.push_back(root_voxel);
 
@@ -330,194 +800,927 @@ namespace Cascade_Graphics
 
         static const uint32_t WORKER_THREAD_COUNT = 32;
 
-        bool work_complete = false;
-        std::mutex work_complete_mutex;
-
         std::mutex voxels_mutex;
+        uint32_t reserved_voxel_count = 0;
+        uint32_t truncated_depth = max_depth;
 
-        uint32_t active_workers_count = 0;
-        std::queue<uint32_t> available_workers_queue;
-        std::mutex available_workers_queue_mutex;
-        std::condition_variable available_worker_notify;
-
-        std::stack<uint32_t> leaf_nodes_stack;
-        std::mutex leaf_nodes_stack_mutex;
-        std::condition_variable available_leaf_node_notify;
-        leaf_nodes_stack.push(0);
+        // A budgeted build refines one level per pass, otherwise cheap deep nodes would use up the budget before slow shallow ones finish
+        std::vector<uint32_t> phase_voxels = {0};
+        std::vector<uint32_t> deferred_voxels;
+        std::vector<uint32_t>* deferred_voxels_ptr = max_voxel_count != 0 ? &deferred_voxels : nullptr;
 
-        std::array<std::thread, WORKER_THREAD_COUNT> worker_threads;
-        std::array<bool, WORKER_THREAD_COUNT> worker_thread_work_available;
-        std::array<uint32_t, WORKER_THREAD_COUNT> worker_thread_current_work;
-        std::array<std::mutex, WORKER_THREAD_COUNT> worker_thread_mutexes;
-        std::array<std::condition_variable, WORKER_THREAD_COUNT> worker_threads_notifies;
-
-        for (uint32_t i = 0; i < WORKER_THREAD_COUNT; i++)
+        while (!phase_voxels.empty())
         {
-            std::lock_guard<std::mutex> worker_thread_lock(worker_thread_mutexes[i]);
-
-            worker_thread_work_available[i] = false;
-            worker_thread_current_work[i] = 0;
-
-            std::thread worker_thread(Object_From_Volume_Function_Worker_Thread, max_depth, step_count_lookup_table, step_size, i, volume_sample_function, color_sample_function, &m_objects.back().voxels, &voxels_mutex, &work_complete,
-                                      &work_complete_mutex, &active_workers_count, &available_workers_queue, &available_workers_queue_mutex, &available_worker_notify, &leaf_nodes_stack, &leaf_nodes_stack_mutex, &available_leaf_node_notify,
-                                      &worker_thread_work_available[i], &worker_thread_current_work[i], &worker_thread_mutexes[i], &worker_threads_notifies[i]);
+            bool work_complete = false;
+            std::mutex work_complete_mutex;
+
+            uint32_t active_workers_count = 0;
+            std::queue<uint32_t> available_workers_queue;
+            std::mutex available_workers_queue_mutex;
+            std::condition_variable available_worker_notify;
+
+            std::stack<uint32_t> leaf_nodes_stack;
+            std::mutex leaf_nodes_stack_mutex;
+            std::condition_variable available_leaf_node_notify;
+            for (uint32_t i = 0; i < phase_voxels.size(); i++)
+            {
+                leaf_nodes_stack.push(phase_voxels[i]);
+            }
 
-            worker_threads[i] = std::move(worker_thread);
-        }
+            std::array<std::thread, WORKER_THREAD_COUNT> worker_threads;
+            std::array<bool, WORKER_THREAD_COUNT> worker_thread_work_available;
+            std::array<uint32_t, WORKER_THREAD_COUNT> worker_thread_current_work;
+            std::array<std::mutex, WORKER_THREAD_COUNT> worker_thread_mutexes;
+            std::array<std::condition_variable, WORKER_THREAD_COUNT> worker_threads_notifies;
 
-        uint32_t selected_worker;
-        uint32_t selected_leaf_node;
-        while (true)
-        {
+            for (uint32_t i = 0; i < WORKER_THREAD_COUNT; i++)
             {
-                // Wait for available worker
+                std::lock_guard<std::mutex> worker_thread_lock(worker_thread_mutexes[i]);
 
-                std::unique_lock<std::mutex> available_workers_queue_lock(available_workers_queue_mutex);
-                available_worker_notify.wait(available_workers_queue_lock, [&available_workers_queue] { return !available_workers_queue.empty(); });
+                worker_thread_work_available[i] = false;
+                worker_thread_current_work[i] = 0;
 
-                selected_worker = available_workers_queue.front();
-                available_workers_queue.pop();
+                std::thread worker_thread(Object_From_Volume_Function_Worker_Thread, max_depth, step_count_lookup_table, step_size, plane_error_tolerance, max_voxel_count, i, volume_sample_function, volume_bounds_function, color_sample_function, sdf_graph_ptr, &m_objects.back().voxels, &voxels_mutex, &reserved_voxel_count, &truncated_depth, &work_complete,
+                                          &work_complete_mutex, &active_workers_count, &available_workers_queue, &available_workers_queue_mutex, &available_worker_notify, &leaf_nodes_stack, &leaf_nodes_stack_mutex, &available_leaf_node_notify, deferred_voxels_ptr,
+                                          &worker_thread_work_available[i], &worker_thread_current_work[i], &worker_thread_mutexes[i], &worker_threads_notifies[i]);
+
+                worker_threads[i] = std::move(worker_thread);
             }
+
+            uint32_t selected_worker;
+            uint32_t selected_leaf_node;
+            while (true)
             {
-                // Wait for available work
+                {
+                    // Wait for available worker
 
-                std::unique_lock<std::mutex> leaf_nodes_stack_lock(leaf_nodes_stack_mutex);
-                available_leaf_node_notify.wait(leaf_nodes_stack_lock, [&leaf_nodes_stack] { return !leaf_nodes_stack.empty(); });
+                    std::unique_lock<std::mutex> available_workers_queue_lock(available_workers_queue_mutex);
+                    available_worker_notify.wait(available_workers_queue_lock, [&available_workers_queue] { return !available_workers_queue.empty(); });
 
+                    selected_worker = available_workers_queue.front();
+                    available_workers_queue.pop();
+                }
                 {
-                    work_complete_mutex.lock();
+                    // Wait for available work
 
-                    bool close_idle_threads = work_complete;
+                    std::unique_lock<std::mutex> leaf_nodes_stack_lock(leaf_nodes_stack_mutex);
+                    available_leaf_node_notify.wait(leaf_nodes_stack_lock, [&leaf_nodes_stack] { return !leaf_nodes_stack.empty(); });
 
-                    work_complete_mutex.unlock();
-
-                    if (close_idle_threads)
                     {
-                        for (uint32_t i = 0; i < WORKER_THREAD_COUNT; i++)
+                        work_complete_mutex.lock();
+
+                        bool close_idle_threads = work_complete;
+
+                        work_complete_mutex.unlock();
+
+                        if (close_idle_threads)
                         {
+                            for (uint32_t i = 0; i < WORKER_THREAD_COUNT; i++)
                             {
-                                std::lock_guard<std::mutex> worker_thread_lock(worker_thread_mutexes[i]);
+                                {
+                                    std::lock_guard<std::mutex> worker_thread_lock(worker_thread_mutexes[i]);
+
+                                    worker_thread_work_available[i] = true;
+                                    worker_threads_notifies[i].notify_all();
+                                }
 
-                                worker_thread_work_available[i] = true;
-                                worker_threads_notifies[i].notify_all();
+                                worker_threads[i].join();
                             }
 
-                            worker_threads[i].join();
+                            break;
                         }
-
-                        break;
                     }
+
+                    selected_leaf_node = leaf_nodes_stack.top();
+                    leaf_nodes_stack.pop();
                 }
+                {
+                    // Send work to worker
+
+                    std::lock_guard<std::mutex> worker_lock(worker_thread_mutexes[selected_worker]);
+                    std::lock_guard<std::mutex> available_workers_queue_lock(available_workers_queue_mutex);
 
-                selected_leaf_node = leaf_nodes_stack.top();
-                leaf_nodes_stack.pop();
+                    worker_thread_current_work[selected_worker] = selected_leaf_node;
+                    worker_thread_work_available[selected_worker] = true;
+                    active_workers_count++;
+
+                    worker_threads_notifies[selected_worker].notify_all();
+                }
             }
-            {
-                // Send work to worker
 
-                std::lock_guard<std::mutex> worker_lock(worker_thread_mutexes[selected_worker]);
-                std::lock_guard<std::mutex> available_workers_queue_lock(available_workers_queue_mutex);
+            phase_voxels = std::move(deferred_voxels);
+            deferred_voxels.clear();
+        }
 
-                worker_thread_current_work[selected_worker] = selected_leaf_node;
-                worker_thread_work_available[selected_worker] = true;
-                active_workers_count++;
+        m_objects.back().effective_depth = truncated_depth;
 
-                worker_threads_notifies[selected_worker].notify_all();
-            }
+        if (truncated_depth != max_depth)
+        {
+            LOG_INFO << "Graphics: Object '" << label << "' reached its budget of " << max_voxel_count << " voxels, it is only fully refined to depth " << truncated_depth << " of " << max_depth;
         }
 
-        uint32_t root_voxel_index = m_gpu_voxels.size();
+        uint32_t root_voxel_index = m_gpu_voxel_count;
 
         m_gpu_objects.resize(m_gpu_objects.size() + 1);
 
         m_gpu_objects.back() = {};
         m_gpu_objects.back().root_voxel_index = root_voxel_index;
 
-        for (uint32_t i = 0; i < m_objects.back().voxels.size(); i++)
-        {
-            Voxel* current_voxel = &m_objects.back().voxels[i];
-
-            GPU_Voxel gpu_voxel = {};
-            gpu_voxel.position_x = static_cast<float>(current_voxel->position.m_x);
-            gpu_voxel.position_y = static_cast<float>(current_voxel->position.m_y);
-            gpu_voxel.position_z = static_cast<float>(current_voxel->position.m_z);
-            gpu_voxel.size = static_cast<float>(current_voxel->size);
-            gpu_voxel.hit_links[0] = (current_voxel->hit_links[0] == (uint32_t)-1) ? -1 : current_voxel->hit_links[0] + root_voxel_index;
-            gpu_voxel.hit_links[1] = (current_voxel->hit_links[1] == (uint32_t)-1) ? -1 : current_voxel->hit_links[1] + root_voxel_index;
-            gpu_voxel.hit_links[2] = (current_voxel->hit_links[2] == (uint32_t)-1) ? -1 : current_voxel->hit_links[2] + root_voxel_index;
-            gpu_voxel.hit_links[3] = (current_voxel->hit_links[3] == (uint32_t)-1) ? -1 : current_voxel->hit_links[3] + root_voxel_index;
-            gpu_voxel.hit_links[4] = (current_voxel->hit_links[4] == (uint32_t)-1) ? -1 : current_voxel->hit_links[4] + root_voxel_index;
-            gpu_voxel.hit_links[5] = (current_voxel->hit_links[5] == (uint32_t)-1) ? -1 : current_voxel->hit_links[5] + root_voxel_index;
-            gpu_voxel.hit_links[6] = (current_voxel->hit_links[6] == (uint32_t)-1) ? -1 : current_voxel->hit_links[6] + root_voxel_index;
-            gpu_voxel.hit_links[7] = (current_voxel->hit_links[7] == (uint32_t)-1) ? -1 : current_voxel->hit_links[7] + root_voxel_index;
-            gpu_voxel.miss_links[0] = (current_voxel->miss_links[0] == (uint32_t)-1) ? (uint32_t)-1 : current_voxel->miss_links[0] + root_voxel_index;
-            gpu_voxel.miss_links[1] = (current_voxel->miss_links[1] == (uint32_t)-1) ? (uint32_t)-1 : current_voxel->miss_links[1] + root_voxel_index;
-            gpu_voxel.miss_links[2] = (current_voxel->miss_links[2] == (uint32_t)-1) ? (uint32_t)-1 : current_voxel->miss_links[2] + root_voxel_index;
-            gpu_voxel.miss_links[3] = (current_voxel->miss_links[3] == (uint32_t)-1) ? (uint32_t)-1 : current_voxel->miss_links[3] + root_voxel_index;
-            gpu_voxel.miss_links[4] = (current_voxel->miss_links[4] == (uint32_t)-1) ? (uint32_t)-1 : current_voxel->miss_links[4] + root_voxel_index;
-            gpu_voxel.miss_links[5] = (current_voxel->miss_links[5] == (uint32_t)-1) ? (uint32_t)-1 : current_voxel->miss_links[5] + root_voxel_index;
-            gpu_voxel.miss_links[6] = (current_voxel->miss_links[6] == (uint32_t)-1) ? (uint32_t)-1 : current_voxel->miss_links[6] + root_voxel_index;
-            gpu_voxel.miss_links[7] = (current_voxel->miss_links[7] == (uint32_t)-1) ? (uint32_t)-1 : current_voxel->miss_links[7] + root_voxel_index;
-            gpu_voxel.normal_x = static_cast<float>(current_voxel->normal.m_x);
-            gpu_voxel.normal_y = static_cast<float>(current_voxel->normal.m_y);
-            gpu_voxel.normal_z = static_cast<float>(current_voxel->normal.m_z);
-            gpu_voxel.color_r = static_cast<float>(current_voxel->color.m_x);
-            gpu_voxel.color_g = static_cast<float>(current_voxel->color.m_y);
-            gpu_voxel.color_b = static_cast<float>(current_voxel->color.m_z);
-            gpu_voxel.plane_pos_x = current_voxel->position.m_x + current_voxel->normal.m_x * current_voxel->plane_offset;
-            gpu_voxel.plane_pos_y = current_voxel->position.m_y + current_voxel->normal.m_y * current_voxel->plane_offset;
-            gpu_voxel.plane_pos_z = current_voxel->position.m_z + current_voxel->normal.m_z * current_voxel->plane_offset;
-
-            m_gpu_voxels.push_back(gpu_voxel);
-        }
+        uint32_t voxel_count = static_cast<uint32_t>(m_objects.back().voxels.size());
+
+        // Voxels are converted to the GPU layout while they are uploaded, the bounds use the root as the GPU sees it after it was narrowed to floats
+        const Voxel& object_root_voxel = m_objects.back().voxels.front();
+        m_objects.back().root_position = Vector_3<double>(static_cast<float>(object_root_voxel.position.m_x), static_cast<float>(object_root_voxel.position.m_y), static_cast<float>(object_root_voxel.position.m_z));
+        m_objects.back().root_size = static_cast<float>(object_root_voxel.size);
+        m_objects.back().gpu_voxel_count = voxel_count;
+
+        m_gpu_voxel_count += voxel_count;
 
         LOG_TRACE << "Graphics: It took " << (float)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count() / 1000.0 << " seconds to generate " << label;
     }
 
-    Object_Manager::Object* Object_Manager::Get_Object(std::string label)
+    void Object_Manager::Create_Object_From_SDF_Graph(std::string label,
+                                                      uint32_t max_depth,
+                                                      Vector_3<double> sample_region_center,
+                                                      double sample_region_size,
+                                                      const SDF_Graph& sdf_graph,
+                                                      std::function<Vector_3<double>(Vector_3<double>, Vector_3<double>)> color_sample_function,
+                                                      double plane_error_tolerance,
+                                                      uint32_t max_voxel_count)
+    {
+        Build_Object_From_Volume_Function(label, max_depth, sample_region_center, sample_region_size, sdf_graph.Get_Volume_Function(), sdf_graph.Get_Volume_Bounds_Function(), color_sample_function, &sdf_graph, plane_error_tolerance, max_voxel_count);
+    }
+
+    void Object_Manager::Create_Object_From_GPU_Voxel_Range(std::string label, uint32_t root_voxel_index, uint32_t voxel_count, Vector_3<double> root_position, double root_size, uint32_t effective_depth)
     {
         for (uint32_t i = 0; i < m_objects.size(); i++)
         {
             if (m_objects[i].label == label)
             {
-                return &m_objects[i];
+                LOG_ERROR << "Graphics: The label '" << label << "' is already in use";
+                exit(EXIT_FAILURE);
             }
         }
 
-        LOG_ERROR << "Graphics: No object with the label " << label << " exists";
-        exit(EXIT_FAILURE);
+        // The voxels were placed in the voxel buffer right after the ones already known, so nothing may have been added since
+        if (root_voxel_index != m_gpu_voxel_count)
+        {
+            LOG_ERROR << "Graphics: Object '" << label << "' was built at voxel " << root_voxel_index << " but the voxel buffer now ends at voxel " << m_gpu_voxel_count;
+            exit(EXIT_FAILURE);
+        }
+
+        // There is no host side tree for these objects, so they are skipped by raycasts and overlap queries
+        m_objects.emplace_back();
+        m_objects.back() = {};
+        m_objects.back().label = label;
+        m_objects.back().position = Vector_3<double>(0.0, 0.0, 0.0);
+        m_objects.back().scale = Vector_3<double>(1.0, 1.0, 1.0);
+        m_objects.back().effective_depth = effective_depth;
+        m_objects.back().root_position = root_position;
+        m_objects.back().root_size = root_size;
+        m_objects.back().voxel_retention_policy = RELEASE_VOXELS;
+        m_objects.back().gpu_voxel_count = voxel_count;
+
+        m_gpu_objects.resize(m_gpu_objects.size() + 1);
+
+        m_gpu_objects.back() = {};
+        m_gpu_objects.back().root_voxel_index = root_voxel_index;
+
+        if (m_uploaded_gpu_voxel_count == m_gpu_voxel_count)
+        {
+            m_uploaded_gpu_voxel_count += voxel_count;
+        }
+        m_gpu_voxel_count += voxel_count;
+
+        LOG_INFO << "Graphics: Added object '" << label << "' with " << voxel_count << " voxels built on the GPU";
     }
 
-    std::vector<Object_Manager::GPU_Object> Object_Manager::Get_GPU_Objects()
+    void Object_Manager::Convert_To_GPU_Voxels(const Voxel* voxels_ptr, GPU_Voxel* gpu_voxels_ptr, uint32_t voxel_count, uint32_t root_voxel_index)
     {
-        for (uint32_t i = 0; i < m_objects.size(); i++)
+        for (uint32_t i = 0; i < voxel_count; i++)
         {
-            float sin_yaw = sin(m_objects[i].rotation.m_x);
-            float cos_yaw = cos(m_objects[i].rotation.m_x);
-            float sin_pitch = sin(m_objects[i].rotation.m_y);
-            float cos_pitch = cos(m_objects[i].rotation.m_y);
-            float sin_roll = sin(m_objects[i].rotation.m_z);
-            float cos_roll = cos(m_objects[i].rotation.m_z);
-
-            m_gpu_objects[i].object_to_world_matrix_x0 = m_objects[i].scale.m_x * (cos_pitch * cos_roll);
-            m_gpu_objects[i].object_to_world_matrix_x1 = m_objects[i].scale.m_x * (sin_yaw * sin_pitch * cos_roll - cos_yaw * sin_roll);
-            m_gpu_objects[i].object_to_world_matrix_x2 = m_objects[i].scale.m_x * (cos_yaw * sin_pitch * cos_roll + sin_yaw * sin_roll);
-            m_gpu_objects[i].object_to_world_matrix_x3 = m_objects[i].position.m_x;
-            m_gpu_objects[i].object_to_world_matrix_y0 = m_objects[i].scale.m_y * (cos_pitch * sin_roll);
-            m_gpu_objects[i].object_to_world_matrix_y1 = m_objects[i].scale.m_y * (sin_yaw * sin_pitch * sin_roll + cos_yaw * cos_roll);
-            m_gpu_objects[i].object_to_world_matrix_y2 = m_objects[i].scale.m_y * (cos_yaw * sin_pitch * sin_roll - sin_yaw * cos_roll);
-            m_gpu_objects[i].object_to_world_matrix_y3 = m_objects[i].position.m_y;
-            m_gpu_objects[i].object_to_world_matrix_z0 = m_objects[i].scale.m_z * (-sin_pitch);
-            m_gpu_objects[i].object_to_world_matrix_z1 = m_objects[i].scale.m_z * (sin_yaw * cos_pitch);
-            m_gpu_objects[i].object_to_world_matrix_z2 = m_objects[i].scale.m_z * (cos_yaw * cos_pitch);
-            m_gpu_objects[i].object_to_world_matrix_z3 = m_objects[i].position.m_z;
+            const Voxel& voxel = voxels_ptr[i];
+            GPU_Voxel& gpu_voxel = gpu_voxels_ptr[i];
+
+            gpu_voxel.position_x = static_cast<float>(voxel.position.m_x);
+            gpu_voxel.position_y = static_cast<float>(voxel.position.m_y);
+            gpu_voxel.position_z = static_cast<float>(voxel.position.m_z);
+            gpu_voxel.size = static_cast<float>(voxel.size);
+
+            // Branchless so the compiler can vectorize the rebase, -1 stays -1
+            for (uint32_t j = 0; j < 8; j++)
+            {
+                gpu_voxel.hit_links[j] = voxel.hit_links[j] + (voxel.hit_links[j] != (uint32_t)-1) * root_voxel_index;
+                gpu_voxel.miss_links[j] = voxel.miss_links[j] + (voxel.miss_links[j] != (uint32_t)-1) * root_voxel_index;
+            }
+
+            gpu_voxel.normal_x = static_cast<float>(voxel.normal.m_x);
+            gpu_voxel.normal_y = static_cast<float>(voxel.normal.m_y);
+            gpu_voxel.normal_z = static_cast<float>(voxel.normal.m_z);
+            gpu_voxel.color_r = static_cast<float>(voxel.color.m_x);
+            gpu_voxel.color_g = static_cast<float>(voxel.color.m_y);
+            gpu_voxel.color_b = static_cast<float>(voxel.color.m_z);
+            gpu_voxel.plane_pos_x = static_cast<float>(voxel.position.m_x + voxel.normal.m_x * voxel.plane_offset);
+            gpu_voxel.plane_pos_y = static_cast<float>(voxel.position.m_y + voxel.normal.m_y * voxel.plane_offset);
+            gpu_voxel.plane_pos_z = static_cast<float>(voxel.position.m_z + voxel.normal.m_z * voxel.plane_offset);
+            gpu_voxel.padding_a = 0;
+            gpu_voxel.padding_b = 0;
+            gpu_voxel.padding_c = 0;
         }
+    }
 
-        return m_gpu_objects;
+    uint32_t Object_Manager::Get_Voxel_Count(const Object& object)
+    {
+        return static_cast<uint32_t>(object.voxels.empty() ? object.compact_voxels.size() : object.voxels.size());
     }
 
-    std::vector<Object_Manager::GPU_Voxel> Object_Manager::Get_GPU_Voxels()
+    Object_Manager::Voxel_Geometry Object_Manager::Get_Voxel_Geometry(const Object& object, uint32_t voxel_index)
     {
-        return m_gpu_voxels;
+        Voxel_Geometry geometry = {};
+
+        if (!object.voxels.empty())
+        {
+            const Voxel& voxel = object.voxels[voxel_index];
+
+            geometry.position = voxel.position;
+            geometry.size = voxel.size;
+            geometry.normal = voxel.normal;
+            geometry.plane_offset = voxel.plane_offset;
+            geometry.hit_links = voxel.hit_links;
+            geometry.miss_links = voxel.miss_links;
+            geometry.is_leaf = voxel.is_leaf;
+            geometry.solid_child_mask = voxel.solid_child_mask;
+        }
+        else
+        {
+            const Compact_Voxel& voxel = object.compact_voxels[voxel_index];
+
+            geometry.position = Vector_3<double>(voxel.position_x, voxel.position_y, voxel.position_z);
+            geometry.size = voxel.size;
+            geometry.normal = Vector_3<double>(voxel.normal_x / 32767.0, voxel.normal_y / 32767.0, voxel.normal_z / 32767.0);
+            geometry.plane_offset = voxel.plane_offset;
+            geometry.hit_links = voxel.hit_links;
+            geometry.miss_links = voxel.miss_links;
+            geometry.is_leaf = voxel.is_leaf;
+            geometry.solid_child_mask = voxel.solid_child_mask;
+        }
+
+        return geometry;
+    }
+
+    Object_Manager::Compact_Voxel Object_Manager::Compress_Voxel(const Voxel& voxel)
+    {
+        Compact_Voxel compact_voxel = {};
+        compact_voxel.position_x = static_cast<float>(voxel.position.m_x);
+        compact_voxel.position_y = static_cast<float>(voxel.position.m_y);
+        compact_voxel.position_z = static_cast<float>(voxel.position.m_z);
+        compact_voxel.size = static_cast<float>(voxel.size);
+        compact_voxel.plane_offset = static_cast<float>(voxel.plane_offset);
+        compact_voxel.normal_x = static_cast<int16_t>(round(std::min(std::max(voxel.normal.m_x, -1.0), 1.0) * 32767.0));
+        compact_voxel.normal_y = static_cast<int16_t>(round(std::min(std::max(voxel.normal.m_y, -1.0), 1.0) * 32767.0));
+        compact_voxel.normal_z = static_cast<int16_t>(round(std::min(std::max(voxel.normal.m_z, -1.0), 1.0) * 32767.0));
+        compact_voxel.color_r = static_cast<uint8_t>(round(std::min(std::max(voxel.color.m_x, 0.0), 1.0) * 255.0));
+        compact_voxel.color_g = static_cast<uint8_t>(round(std::min(std::max(voxel.color.m_y, 0.0), 1.0) * 255.0));
+        compact_voxel.color_b = static_cast<uint8_t>(round(std::min(std::max(voxel.color.m_z, 0.0), 1.0) * 255.0));
+        compact_voxel.solid_child_mask = voxel.solid_child_mask;
+        compact_voxel.is_leaf = voxel.is_leaf;
+
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            compact_voxel.hit_links[i] = voxel.hit_links[i];
+            compact_voxel.miss_links[i] = voxel.miss_links[i];
+        }
+
+        return compact_voxel;
+    }
+
+    size_t Object_Manager::Get_Object_Host_Memory_Usage(const Object& object)
+    {
+        return sizeof(Object) + object.label.capacity() + object.voxels.capacity() * sizeof(Voxel) + object.compact_voxels.capacity() * sizeof(Compact_Voxel);
+    }
+
+    Object_Manager::Object_Space_Volume Object_Manager::Get_Object_Space_Volume(const Object_Transform& transform, const Overlap_Query& query)
+    {
+        const double(&m)[3][4] = transform.world_to_object;
+
+        Object_Space_Volume volume = {};
+        volume.position = Transform_Point(m, query.position);
+
+        switch (query.shape)
+        {
+            case POINT:
+            {
+                volume.is_sphere = false;
+                volume.half_size = Vector_3<double>(0.0, 0.0, 0.0);
+                break;
+            }
+            case SPHERE:
+            {
+                // The largest column of the inverse transform is the largest stretch it applies, so the sphere stays exact for uniform scale and is bounded otherwise
+                double max_column_length = 0.0;
+                for (uint32_t column = 0; column < 3; column++)
+                {
+                    max_column_length = std::max(max_column_length, sqrt(m[0][column] * m[0][column] + m[1][column] * m[1][column] + m[2][column] * m[2][column]));
+                }
+
+                volume.is_sphere = true;
+                volume.radius = query.radius * max_column_length;
+                break;
+            }
+            case BOX:
+            {
+                volume.is_sphere = false;
+                volume.half_size = Vector_3<double>(fabs(m[0][0]) * query.half_size.m_x + fabs(m[0][1]) * query.half_size.m_y + fabs(m[0][2]) * query.half_size.m_z,
+                                                    fabs(m[1][0]) * query.half_size.m_x + fabs(m[1][1]) * query.half_size.m_y + fabs(m[1][2]) * query.half_size.m_z,
+                                                    fabs(m[2][0]) * query.half_size.m_x + fabs(m[2][1]) * query.half_size.m_y + fabs(m[2][2]) * query.half_size.m_z);
+                break;
+            }
+        }
+
+        return volume;
+    }
+
+    bool Object_Manager::Volume_Box_Overlap(const Object_Space_Volume& volume, Vector_3<double> box_position, double box_size)
+    {
+        if (volume.is_sphere)
+        {
+            double dx = std::max(fabs(volume.position.m_x - box_position.m_x) - box_size, 0.0);
+            double dy = std::max(fabs(volume.position.m_y - box_position.m_y) - box_size, 0.0);
+            double dz = std::max(fabs(volume.position.m_z - box_position.m_z) - box_size, 0.0);
+
+            return dx * dx + dy * dy + dz * dz <= volume.radius * volume.radius;
+        }
+
+        return fabs(volume.position.m_x - box_position.m_x) <= volume.half_size.m_x + box_size && fabs(volume.position.m_y - box_position.m_y) <= volume.half_size.m_y + box_size
+               && fabs(volume.position.m_z - box_position.m_z) <= volume.half_size.m_z + box_size;
+    }
+
+    bool Object_Manager::Volume_Leaf_Overlap(const Object_Space_Volume& volume, const Voxel_Geometry& voxel)
+    {
+        Vector_3<double> voxel_position = voxel.position;
+        Vector_3<double> normal = voxel.normal;
+        Vector_3<double> plane_position = voxel_position + normal * voxel.plane_offset;
+        Vector_3<double> volume_position = volume.position;
+        Vector_3<double> voxel_min = voxel_position - voxel.size;
+        Vector_3<double> voxel_max = voxel_position + voxel.size;
+
+        if (volume.is_sphere)
+        {
+            // The sphere has to reach the part of the leaf behind the plane, not just the plane somewhere outside the leaf
+            Vector_3<double> closest_point = Vector_3<double>(std::min(std::max(volume_position.m_x, voxel_min.m_x), voxel_max.m_x), std::min(std::max(volume_position.m_y, voxel_min.m_y), voxel_max.m_y),
+                                                              std::min(std::max(volume_position.m_z, voxel_min.m_z), voxel_max.m_z));
+            if ((closest_point - volume_position).Length() > volume.radius || Vector_3<double>::Dot(volume_position - plane_position, normal) - volume.radius > 0.0)
+            {
+                return false;
+            }
+            if (Vector_3<double>::Dot(closest_point - plane_position, normal) <= 0.0)
+            {
+                return true;
+            }
+        }
+
+        // Clip the query box to the voxel, then check whether any corner of the clipped box is behind the plane
+        Vector_3<double> volume_half_size = volume.is_sphere ? Vector_3<double>(volume.radius, volume.radius, volume.radius) : volume.half_size;
+        Vector_3<double> volume_min = volume_position - volume_half_size;
+        Vector_3<double> volume_max = volume_position + volume_half_size;
+
+        Vector_3<double> clipped_min = Vector_3<double>(std::max(volume_min.m_x, voxel_min.m_x), std::max(volume_min.m_y, voxel_min.m_y), std::max(volume_min.m_z, voxel_min.m_z));
+        Vector_3<double> clipped_max = Vector_3<double>(std::min(volume_max.m_x, voxel_max.m_x), std::min(volume_max.m_y, voxel_max.m_y), std::min(volume_max.m_z, voxel_max.m_z));
+        Vector_3<double> clipped_position = (clipped_min + clipped_max) * 0.5;
+        Vector_3<double> clipped_half_size = (clipped_max - clipped_min) * 0.5;
+
+        return Vector_3<double>::Dot(clipped_position - plane_position, normal) - (fabs(normal.m_x) * clipped_half_size.m_x + fabs(normal.m_y) * clipped_half_size.m_y + fabs(normal.m_z) * clipped_half_size.m_z) <= 0.0;
+    }
+
+    bool Object_Manager::Volume_Octree_Overlap(const Object_Space_Volume& volume, const Object& object, uint32_t voxel_index)
+    {
+        Voxel_Geometry voxel = Get_Voxel_Geometry(object, voxel_index);
+
+        if (voxel.is_leaf)
+        {
+            return Volume_Leaf_Overlap(volume, voxel);
+        }
+
+        double child_size = voxel.size * 0.5;
+
+        // Children which were not stored are either fully empty or fully solid
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            if (voxel.solid_child_mask & (1 << i))
+            {
+                Vector_3<double> child_position = voxel.position + Vector_3<double>((i & 1) * voxel.size - child_size, ((i & 2) >> 1) * voxel.size - child_size, ((i & 4) >> 2) * voxel.size - child_size);
+
+                if (Volume_Box_Overlap(volume, child_position, child_size))
+                {
+                    return true;
+                }
+            }
+        }
+
+        // Stored children are chained by their miss links, which leave the parent once the last child is passed
+        uint32_t child_index = voxel.hit_links[0];
+        while (child_index != (uint32_t)-1)
+        {
+            Voxel_Geometry child_voxel = Get_Voxel_Geometry(object, child_index);
+
+            if (child_voxel.size >= voxel.size)
+            {
+                break;
+            }
+
+            if (Volume_Box_Overlap(volume, child_voxel.position, child_voxel.size) && Volume_Octree_Overlap(volume, object, child_index))
+            {
+                return true;
+            }
+
+            child_index = child_voxel.miss_links[0];
+        }
+
+        return false;
+    }
+
+    Object_Manager::Overlap_Result Object_Manager::Scene_Overlap(const std::vector<Object>& objects, const std::vector<Object_Transform>& transforms, const Overlap_Query& query)
+    {
+        Overlap_Result result = {};
+        result.overlapping = false;
+        result.object_index = -1;
+
+        for (uint32_t object_index = 0; object_index < objects.size(); object_index++)
+        {
+            const Object& object = objects[object_index];
+
+            if (Get_Voxel_Count(object) == 0 || !transforms[object_index].is_invertible)
+            {
+                continue;
+            }
+
+            Object_Space_Volume volume = Get_Object_Space_Volume(transforms[object_index], query);
+            Voxel_Geometry root_voxel = Get_Voxel_Geometry(object, 0);
+
+            if (Volume_Box_Overlap(volume, root_voxel.position, root_voxel.size) && Volume_Octree_Overlap(volume, object, 0))
+            {
+                result.overlapping = true;
+                result.object_index = object_index;
+                break;
+            }
+        }
+
+        return result;
+    }
+
+    void Object_Manager::Batch_Overlap_Worker_Thread(const std::vector<Object>* objects_ptr,
+                                                     const std::vector<Object_Transform>* transforms_ptr,
+                                                     const std::vector<Overlap_Query>* queries_ptr,
+                                                     std::vector<Overlap_Result>* results_ptr,
+                                                     uint32_t first_query_index,
+                                                     uint32_t query_count)
+    {
+        for (uint32_t i = first_query_index; i < first_query_index + query_count; i++)
+        {
+            (*results_ptr)[i] = Scene_Overlap(*objects_ptr, *transforms_ptr, (*queries_ptr)[i]);
+        }
+    }
+
+    Object_Manager::Raycast_Hit Object_Manager::Raycast(Vector_3<double> origin, Vector_3<double> direction, double max_distance)
+    {
+        Raycast_Hit closest_hit = {};
+        closest_hit.hit = false;
+        closest_hit.distance = max_distance;
+
+        direction.Normalize();
+
+        for (uint32_t object_index = 0; object_index < m_objects.size(); object_index++)
+        {
+            const Object& object = m_objects[object_index];
+
+            if (Get_Voxel_Count(object) == 0)
+            {
+                continue;
+            }
+
+            Object_Transform transform = Get_Object_Transform(object);
+            if (!transform.is_invertible)
+            {
+                continue;
+            }
+
+            Vector_3<double> transformed_ray_origin = Transform_Point(transform.world_to_object, origin);
+            Vector_3<double> transformed_ray_direction = Transform_Direction(transform.world_to_object, direction).Normalized();
+
+            // Axis aligned rays would otherwise produce 0 * inf in the slab test when they run along a voxel face
+            transformed_ray_direction.m_x = (transformed_ray_direction.m_x == 0.0) ? std::numeric_limits<double>::min() : transformed_ray_direction.m_x;
+            transformed_ray_direction.m_y = (transformed_ray_direction.m_y == 0.0) ? std::numeric_limits<double>::min() : transformed_ray_direction.m_y;
+            transformed_ray_direction.m_z = (transformed_ray_direction.m_z == 0.0) ? std::numeric_limits<double>::min() : transformed_ray_direction.m_z;
+
+            Vector_3<double> fractional_ray_direction = Vector_3<double>(1.0 / transformed_ray_direction.m_x, 1.0 / transformed_ray_direction.m_y, 1.0 / transformed_ray_direction.m_z);
+
+            double object_to_world_distance_scale = Transform_Direction(transform.object_to_world, transformed_ray_direction).Length();
+
+            uint32_t direction_index = (transformed_ray_direction.m_x < 0.0) | ((transformed_ray_direction.m_y < 0.0) << 1) | ((transformed_ray_direction.m_z < 0.0) << 2);
+
+            uint32_t current_index = 0;
+            while (current_index != (uint32_t)-1)
+            {
+                Voxel_Geometry current_voxel = Get_Voxel_Geometry(object, current_index);
+
+                uint32_t hit_index = current_voxel.hit_links[direction_index];
+                uint32_t miss_index = current_voxel.miss_links[direction_index];
+
+                double box_distance;
+                bool box_hit = Ray_Box_Intersection(transformed_ray_origin - current_voxel.position, fractional_ray_direction, current_voxel.size, box_distance);
+
+                if (!box_hit || box_distance * object_to_world_distance_scale > closest_hit.distance)
+                {
+                    current_index = miss_index;
+                    continue;
+                }
+
+                if (hit_index != (uint32_t)-1)
+                {
+                    current_index = hit_index;
+                    continue;
+                }
+
+                Vector_3<double> normal = current_voxel.normal;
+                Vector_3<double> plane_position = current_voxel.position + normal * current_voxel.plane_offset;
+
+                double plane_distance = Vector_3<double>::Dot(plane_position - transformed_ray_origin, normal) / Vector_3<double>::Dot(normal, transformed_ray_direction);
+                Vector_3<double> plane_hit_position = transformed_ray_origin + transformed_ray_direction * plane_distance;
+                Vector_3<double> box_min = current_voxel.position - current_voxel.size;
+                Vector_3<double> box_max = current_voxel.position + current_voxel.size;
+
+                bool plane_hit = plane_distance >= 0.0 && plane_hit_position.m_x > box_min.m_x && plane_hit_position.m_y > box_min.m_y && plane_hit_position.m_z > box_min.m_z && plane_hit_position.m_x < box_max.m_x
+                                 && plane_hit_position.m_y < box_max.m_y && plane_hit_position.m_z < box_max.m_z;
+                if (!plane_hit && Vector_3<double>::Dot(transformed_ray_origin + transformed_ray_direction * box_distance - plane_position, normal) <= 0.0)
+                {
+                    plane_distance = std::max(box_distance, 0.0);
+                    plane_hit = true;
+                }
+
+                if (!plane_hit)
+                {
+                    current_index = miss_index;
+                    continue;
+                }
+
+                Vector_3<double> hit_position = Transform_Point(transform.object_to_world, transformed_ray_origin + transformed_ray_direction * plane_distance);
+                double hit_distance = (hit_position - origin).Length();
+
+                if (hit_distance <= closest_hit.distance)
+                {
+                    closest_hit.hit = true;
+                    closest_hit.object_label = object.label;
+                    closest_hit.object_index = object_index;
+                    closest_hit.voxel_index = current_index;
+                    closest_hit.distance = hit_distance;
+                    closest_hit.position = hit_position;
+                    closest_hit.normal = Transform_Direction(transform.object_to_world, normal).Normalized();
+                }
+
+                break;
+            }
+        }
+
+        return closest_hit;
+    }
+
+    Object_Manager::Overlap_Result Object_Manager::Point_Overlap(Vector_3<double> point)
+    {
+        Overlap_Query query = {};
+        query.shape = POINT;
+        query.position = point;
+
+        return Overlap(query);
+    }
+
+    Object_Manager::Overlap_Result Object_Manager::Sphere_Overlap(Vector_3<double> center, double radius)
+    {
+        Overlap_Query query = {};
+        query.shape = SPHERE;
+        query.position = center;
+        query.radius = radius;
+
+        return Overlap(query);
+    }
+
+    Object_Manager::Overlap_Result Object_Manager::Box_Overlap(Vector_3<double> box_min, Vector_3<double> box_max)
+    {
+        Overlap_Query query = {};
+        query.shape = BOX;
+        query.position = (box_min + box_max) * 0.5;
+        query.half_size = (box_max - box_min) * 0.5;
+
+        return Overlap(query);
+    }
+
+    Object_Manager::Overlap_Result Object_Manager::Overlap(Overlap_Query query)
+    {
+        std::vector<Object_Transform> transforms(m_objects.size());
+        for (uint32_t i = 0; i < m_objects.size(); i++)
+        {
+            transforms[i] = Get_Object_Transform(m_objects[i]);
+        }
+
+        return Scene_Overlap(m_objects, transforms, query);
+    }
+
+    std::vector<Object_Manager::Overlap_Result> Object_Manager::Batch_Overlap(const std::vector<Overlap_Query>& queries)
+    {
+        static const uint32_t MIN_QUERIES_PER_TASK = 64;
+
+        std::vector<Object_Transform> transforms(m_objects.size());
+        for (uint32_t i = 0; i < m_objects.size(); i++)
+        {
+            transforms[i] = Get_Object_Transform(m_objects[i]);
+        }
+
+        std::vector<Overlap_Result> results(queries.size());
+
+        // Handing a small batch to the workers costs more than answering it on the calling thread
+        if (queries.size() < MIN_QUERIES_PER_TASK * 2)
+        {
+            Batch_Overlap_Worker_Thread(&m_objects, &transforms, &queries, &results, 0, queries.size());
+
+            return results;
+        }
+
+        uint32_t task_count = std::min(static_cast<uint32_t>(m_worker_threads.size()) + 1, static_cast<uint32_t>(queries.size()) / MIN_QUERIES_PER_TASK);
+        uint32_t queries_per_task = static_cast<uint32_t>(queries.size()) / task_count;
+        uint32_t remaining_queries = static_cast<uint32_t>(queries.size()) % task_count;
+
+        std::vector<std::function<void()>> tasks;
+        uint32_t first_query_index = 0;
+        for (uint32_t i = 0; i < task_count; i++)
+        {
+            uint32_t query_count = queries_per_task + (i < remaining_queries ? 1 : 0);
+            tasks.push_back(std::bind(Batch_Overlap_Worker_Thread, &m_objects, &transforms, &queries, &results, first_query_index, query_count));
+
+            first_query_index += query_count;
+        }
+
+        Run_Tasks(tasks);
+
+        return results;
+    }
+
+    void Object_Manager::Set_Voxel_Retention_Policy(std::string label, Voxel_Retention_Policy voxel_retention_policy)
+    {
+        Object* object_ptr = Get_Object(label);
+
+        bool voxels_available = !object_ptr->voxels.empty() || (voxel_retention_policy == RETAIN_COMPACT_VOXELS && !object_ptr->compact_voxels.empty());
+        if (voxel_retention_policy < object_ptr->voxel_retention_policy && !voxels_available)
+        {
+            LOG_ERROR << "Graphics: Cannot restore voxels of object '" << label << "' which have already been compacted or released";
+            exit(EXIT_FAILURE);
+        }
+
+        object_ptr->voxel_retention_policy = voxel_retention_policy;
+    }
+
+    void Object_Manager::Apply_Voxel_Retention_Policies()
+    {
+        for (uint32_t i = 0; i < m_objects.size(); i++)
+        {
+            Object& object = m_objects[i];
+
+            // Voxels are converted to the GPU layout while they are uploaded, so the policy only applies once the object is in the voxel buffer
+            if (m_gpu_objects[i].root_voxel_index + object.gpu_voxel_count > m_uploaded_gpu_voxel_count)
+            {
+                continue;
+            }
+
+            switch (object.voxel_retention_policy)
+            {
+                case RETAIN_FULL_VOXELS:
+                {
+                    continue;
+                }
+                case RETAIN_COMPACT_VOXELS:
+                {
+                    if (object.voxels.empty())
+                    {
+                        continue;
+                    }
+
+                    object.compact_voxels.reserve(object.voxels.size());
+                    for (uint32_t j = 0; j < object.voxels.size(); j++)
+                    {
+                        object.compact_voxels.push_back(Compress_Voxel(object.voxels[j]));
+                    }
+
+                    std::vector<Voxel>().swap(object.voxels);
+                    break;
+                }
+                case RELEASE_VOXELS:
+                {
+                    if (Get_Voxel_Count(object) == 0)
+                    {
+                        continue;
+                    }
+
+                    std::vector<Voxel>().swap(object.voxels);
+                    std::vector<Compact_Voxel>().swap(object.compact_voxels);
+                    break;
+                }
+            }
+
+            LOG_DEBUG << "Graphics: Object '" << object.label << "' now uses " << Get_Object_Host_Memory_Usage(object) << " bytes of host memory";
+        }
+    }
+
+    size_t Object_Manager::Get_Host_Memory_Usage()
+    {
+        size_t memory_usage = m_gpu_objects.capacity() * sizeof(GPU_Object) + m_gpu_bvh_nodes.capacity() * sizeof(GPU_BVH_Node);
+
+        for (uint32_t i = 0; i < m_objects.size(); i++)
+        {
+            memory_usage += Get_Object_Host_Memory_Usage(m_objects[i]);
+        }
+
+        return memory_usage;
+    }
+
+    Object_Manager::Object* Object_Manager::Get_Object(std::string label)
+    {
+        for (uint32_t i = 0; i < m_objects.size(); i++)
+        {
+            if (m_objects[i].label == label)
+            {
+                return &m_objects[i];
+            }
+        }
+
+        LOG_ERROR << "Graphics: No object with the label " << label << " exists";
+        exit(EXIT_FAILURE);
+    }
+
+    uint32_t Object_Manager::Get_Effective_Depth(std::string label)
+    {
+        return Get_Object(label)->effective_depth;
+    }
+
+    size_t Object_Manager::Get_Object_Count()
+    {
+        return m_objects.size();
+    }
+
+    const std::vector<Object_Manager::GPU_Object>& Object_Manager::Get_GPU_Objects()
+    {
+        Write_GPU_Objects(m_gpu_objects.data(), 0, m_gpu_objects.size());
+
+        return m_gpu_objects;
+    }
+
+    size_t Object_Manager::Get_GPU_Voxel_Count()
+    {
+        return m_gpu_voxel_count;
+    }
+
+    const std::vector<Object_Manager::GPU_BVH_Node>& Object_Manager::Get_GPU_BVH_Nodes()
+    {
+        m_gpu_bvh_nodes.clear();
+
+        // Objects scaled to zero are left out of the hierarchy, so they are never traversed with their degenerate transform
+        std::vector<Object_Bounds> object_bounds(m_gpu_objects.size());
+        std::vector<uint32_t> object_indices;
+        object_indices.reserve(m_gpu_objects.size());
+        for (uint32_t i = 0; i < m_gpu_objects.size(); i++)
+        {
+            Object_Transform transform = Get_Object_Transform(m_objects[i]);
+            if (transform.is_invertible)
+            {
+                object_bounds[i] = Get_Object_World_Bounds(transform, m_objects[i]);
+                object_indices.push_back(i);
+            }
+        }
+
+        if (object_indices.empty())
+        {
+            // An inverted box is never hit, so the traversal ends immediately
+            GPU_BVH_Node empty_node = {};
+            empty_node.min_x = 1.0f;
+            empty_node.min_y = 1.0f;
+            empty_node.min_z = 1.0f;
+            empty_node.max_x = -1.0f;
+            empty_node.max_y = -1.0f;
+            empty_node.max_z = -1.0f;
+            empty_node.object_index = -1;
+            for (uint32_t i = 0; i < 8; i++)
+            {
+                empty_node.hit_links[i] = -1;
+                empty_node.miss_links[i] = -1;
+            }
+            m_gpu_bvh_nodes.push_back(empty_node);
+
+            return m_gpu_bvh_nodes;
+        }
+
+        std::vector<BVH_Build_Node> build_nodes;
+        m_gpu_bvh_nodes.reserve(object_indices.size() * 2 - 1);
+        build_nodes.reserve(object_indices.size() * 2 - 1);
+
+        Build_BVH_Node(m_gpu_bvh_nodes, build_nodes, object_bounds, object_indices.data(), object_indices.size());
+        for (uint32_t direction_index = 0; direction_index < 8; direction_index++)
+        {
+            Link_BVH_Node(m_gpu_bvh_nodes, build_nodes, direction_index, 0, -1);
+        }
+
+        return m_gpu_bvh_nodes;
+    }
+
+    void Object_Manager::Write_GPU_Objects(GPU_Object* destination_ptr, size_t first_object_index, size_t object_count)
+    {
+        for (size_t i = first_object_index; i < first_object_index + object_count; i++)
+        {
+            Object_Transform transform = Get_Object_Transform(m_objects[i]);
+
+            GPU_Object gpu_object = m_gpu_objects[i];
+            gpu_object.object_to_world_matrix_x0 = static_cast<float>(transform.object_to_world[0][0]);
+            gpu_object.object_to_world_matrix_x1 = static_cast<float>(transform.object_to_world[0][1]);
+            gpu_object.object_to_world_matrix_x2 = static_cast<float>(transform.object_to_world[0][2]);
+            gpu_object.object_to_world_matrix_x3 = static_cast<float>(transform.object_to_world[0][3]);
+            gpu_object.object_to_world_matrix_y0 = static_cast<float>(transform.object_to_world[1][0]);
+            gpu_object.object_to_world_matrix_y1 = static_cast<float>(transform.object_to_world[1][1]);
+            gpu_object.object_to_world_matrix_y2 = static_cast<float>(transform.object_to_world[1][2]);
+            gpu_object.object_to_world_matrix_y3 = static_cast<float>(transform.object_to_world[1][3]);
+            gpu_object.object_to_world_matrix_z0 = static_cast<float>(transform.object_to_world[2][0]);
+            gpu_object.object_to_world_matrix_z1 = static_cast<float>(transform.object_to_world[2][1]);
+            gpu_object.object_to_world_matrix_z2 = static_cast<float>(transform.object_to_world[2][2]);
+            gpu_object.object_to_world_matrix_z3 = static_cast<float>(transform.object_to_world[2][3]);
+            gpu_object.world_to_object_matrix_x0 = static_cast<float>(transform.world_to_object[0][0]);
+            gpu_object.world_to_object_matrix_x1 = static_cast<float>(transform.world_to_object[0][1]);
+            gpu_object.world_to_object_matrix_x2 = static_cast<float>(transform.world_to_object[0][2]);
+            gpu_object.world_to_object_matrix_x3 = static_cast<float>(transform.world_to_object[0][3]);
+            gpu_object.world_to_object_matrix_y0 = static_cast<float>(transform.world_to_object[1][0]);
+            gpu_object.world_to_object_matrix_y1 = static_cast<float>(transform.world_to_object[1][1]);
+            gpu_object.world_to_object_matrix_y2 = static_cast<float>(transform.world_to_object[1][2]);
+            gpu_object.world_to_object_matrix_y3 = static_cast<float>(transform.world_to_object[1][3]);
+            gpu_object.world_to_object_matrix_z0 = static_cast<float>(transform.world_to_object[2][0]);
+            gpu_object.world_to_object_matrix_z1 = static_cast<float>(transform.world_to_object[2][1]);
+            gpu_object.world_to_object_matrix_z2 = static_cast<float>(transform.world_to_object[2][2]);
+            gpu_object.world_to_object_matrix_z3 = static_cast<float>(transform.world_to_object[2][3]);
+
+            Object_Bounds bounds = Get_Object_World_Bounds(transform, m_objects[i]);
+            gpu_object.min_x = static_cast<float>(bounds.min.m_x);
+            gpu_object.min_y = static_cast<float>(bounds.min.m_y);
+            gpu_object.min_z = static_cast<float>(bounds.min.m_z);
+            gpu_object.max_x = static_cast<float>(bounds.max.m_x);
+            gpu_object.max_y = static_cast<float>(bounds.max.m_y);
+            gpu_object.max_z = static_cast<float>(bounds.max.m_z);
+
+            destination_ptr[i - first_object_index] = gpu_object;
+        }
+    }
+
+    void Object_Manager::Write_GPU_Voxels(GPU_Voxel* destination_ptr, size_t first_voxel_index, size_t voxel_count)
+    {
+        static const uint32_t MIN_VOXELS_PER_TASK = 4096;
+
+        for (uint32_t i = 0; i < m_objects.size() && voxel_count > 0; i++)
+        {
+            const Object& object = m_objects[i];
+
+            size_t root_voxel_index = m_gpu_objects[i].root_voxel_index;
+            if (root_voxel_index + object.gpu_voxel_count <= first_voxel_index)
+            {
+                continue;
+            }
+
+            size_t object_first_voxel_index = first_voxel_index - root_voxel_index;
+            size_t object_voxel_count = std::min(voxel_count, root_voxel_index + object.gpu_voxel_count - first_voxel_index);
+
+            // Voxels are converted straight into the destination, objects built on the GPU are copied into the voxel buffer there and never pass through here
+            if (!object.voxels.empty() && object_voxel_count >= 2 * MIN_VOXELS_PER_TASK)
+            {
+                uint32_t task_count = std::min(static_cast<uint32_t>(m_worker_threads.size()) + 1, static_cast<uint32_t>(object_voxel_count) / MIN_VOXELS_PER_TASK);
+                uint32_t voxels_per_task = (object_voxel_count + task_count - 1) / task_count;
+
+                std::vector<std::function<void()>> tasks;
+                for (uint32_t j = 0; j < task_count; j++)
+                {
+                    uint32_t task_first_voxel_index = j * voxels_per_task;
+                    uint32_t task_voxel_count = std::min(voxels_per_task, static_cast<uint32_t>(object_voxel_count) - std::min(task_first_voxel_index, static_cast<uint32_t>(object_voxel_count)));
+
+                    tasks.push_back(std::bind(Convert_To_GPU_Voxels, object.voxels.data() + object_first_voxel_index + task_first_voxel_index, destination_ptr + task_first_voxel_index, task_voxel_count, root_voxel_index));
+                }
+
+                Run_Tasks(tasks);
+            }
+            else if (!object.voxels.empty())
+            {
+                Convert_To_GPU_Voxels(object.voxels.data() + object_first_voxel_index, destination_ptr, object_voxel_count, root_voxel_index);
+            }
+            else
+            {
+                LOG_ERROR << "Graphics: The voxels of object '" << object.label << "' have already been released";
+                exit(EXIT_FAILURE);
+            }
+
+            destination_ptr += object_voxel_count;
+            first_voxel_index += object_voxel_count;
+            voxel_count -= object_voxel_count;
+        }
+
+        m_uploaded_gpu_voxel_count = std::max(m_uploaded_gpu_voxel_count, first_voxel_index);
     }
-} // namespace Cascade_Graphics
\ No newline at end of file
+} // namespace Cascade_Graphics
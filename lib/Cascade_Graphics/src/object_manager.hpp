@@ -1,12 +1,14 @@
 #pragma once
 
 #include "Data_Types/vector_3.hpp"
+#include "sdf_graph.hpp"
 #include <condition_variable>
 #include <functional>
 #include <mutex>
 #include <queue>
 #include <stack>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -60,11 +62,88 @@ namespace Cascade_Graphics
             float object_to_world_matrix_z2;
             float object_to_world_matrix_z3;
 
+            float world_to_object_matrix_x0;
+            float world_to_object_matrix_x1;
+            float world_to_object_matrix_x2;
+            float world_to_object_matrix_x3;
+
+            float world_to_object_matrix_y0;
+            float world_to_object_matrix_y1;
+            float world_to_object_matrix_y2;
+            float world_to_object_matrix_y3;
+
+            float world_to_object_matrix_z0;
+            float world_to_object_matrix_z1;
+            float world_to_object_matrix_z2;
+            float world_to_object_matrix_z3;
+
+            float min_x;
+            float min_y;
+            float min_z;
             uint32_t root_voxel_index;
 
+            float max_x;
+            float max_y;
+            float max_z;
             uint32_t padding_a;
-            uint32_t padding_b;
-            uint32_t padding_c;
+        };
+
+        struct GPU_BVH_Node
+        {
+            float min_x;
+            float min_y;
+            float min_z;
+            uint32_t object_index;
+
+            float max_x;
+            float max_y;
+            float max_z;
+            uint32_t padding_a;
+
+            uint32_t hit_links[8];
+            uint32_t miss_links[8];
+        };
+
+        struct Raycast_Hit
+        {
+            bool hit;
+
+            std::string object_label;
+            uint32_t object_index;
+            uint32_t voxel_index;
+
+            double distance;
+            Vector_3<double> position;
+            Vector_3<double> normal;
+        };
+
+        enum Overlap_Shape
+        {
+            POINT,
+            SPHERE,
+            BOX
+        };
+
+        struct Overlap_Query
+        {
+            Overlap_Shape shape;
+
+            Vector_3<double> position;
+            Vector_3<double> half_size;
+            double radius;
+        };
+
+        struct Overlap_Result
+        {
+            bool overlapping;
+            uint32_t object_index;
+        };
+
+        enum Voxel_Retention_Policy
+        {
+            RETAIN_FULL_VOXELS,
+            RETAIN_COMPACT_VOXELS,
+            RELEASE_VOXELS
         };
 
     private:
@@ -84,6 +163,30 @@ namespace Cascade_Graphics
 
             uint32_t depth;
             bool is_leaf;
+            uint8_t solid_child_mask;
+        };
+
+        struct Compact_Voxel
+        {
+            float position_x;
+            float position_y;
+            float position_z;
+            float size;
+            float plane_offset;
+
+            int16_t normal_x;
+            int16_t normal_y;
+            int16_t normal_z;
+
+            uint8_t color_r;
+            uint8_t color_g;
+            uint8_t color_b;
+
+            uint8_t solid_child_mask;
+            bool is_leaf;
+
+            uint32_t hit_links[8];
+            uint32_t miss_links[8];
         };
 
         struct Object
@@ -94,26 +197,141 @@ namespace Cascade_Graphics
             Vector_3<double> scale;
             Vector_3<double> rotation;
 
+            uint32_t effective_depth;
+
+            Vector_3<double> root_position;
+            double root_size;
+
+            Voxel_Retention_Policy voxel_retention_policy;
             std::vector<Voxel> voxels;
+            std::vector<Compact_Voxel> compact_voxels;
+
+            uint32_t gpu_voxel_count;
+        };
+
+        struct Voxel_Geometry
+        {
+            Vector_3<double> position;
+            double size;
+            Vector_3<double> normal;
+            double plane_offset;
+
+            const uint32_t* hit_links;
+            const uint32_t* miss_links;
+
+            bool is_leaf;
+            uint8_t solid_child_mask;
+        };
+
+        struct Object_Transform
+        {
+            double object_to_world[3][4];
+            double world_to_object[3][4];
+            bool is_invertible;
+        };
+
+        struct Object_Bounds
+        {
+            Vector_3<double> min;
+            Vector_3<double> max;
+        };
+
+        struct BVH_Build_Node
+        {
+            uint32_t right_child_index;
+            uint32_t split_axis;
+        };
+
+        struct Object_Space_Volume
+        {
+            bool is_sphere;
+
+            Vector_3<double> position;
+            Vector_3<double> half_size;
+            double radius;
         };
 
     private:
         std::vector<Object> m_objects;
         std::vector<GPU_Object> m_gpu_objects;
-        std::vector<GPU_Voxel> m_gpu_voxels;
+        size_t m_gpu_voxel_count = 0;
+        size_t m_uploaded_gpu_voxel_count = 0;
+        std::vector<GPU_BVH_Node> m_gpu_bvh_nodes;
+
+        std::vector<std::thread> m_worker_threads;
+        std::queue<std::function<void()>> m_task_queue;
+        std::mutex m_task_queue_mutex;
+        std::condition_variable m_task_available_notify;
+        std::condition_variable m_tasks_complete_notify;
+        uint32_t m_pending_task_count = 0;
+        bool m_workers_active = true;
 
     private:
-        static void
-        Voxel_Sample_Volume_Function(Vector_3<double> voxel_position, double voxel_size, double step_size, uint32_t step_count, std::function<double(Vector_3<double>)> volume_sample_function, bool& is_fully_contained, bool& is_intersecting);
+        static void Worker_Loop(Object_Manager* instance);
+        void Run_Tasks(std::vector<std::function<void()>>& tasks);
+
+        static Object_Transform Get_Object_Transform(const Object& object);
+        static Vector_3<double> Transform_Point(const double matrix[3][4], Vector_3<double> point);
+        static Vector_3<double> Transform_Direction(const double matrix[3][4], Vector_3<double> direction);
+        static bool Ray_Box_Intersection(Vector_3<double> ray_origin, Vector_3<double> fractional_ray_direction, double box_size, double& distance);
+        static Object_Bounds Get_Object_World_Bounds(const Object_Transform& transform, const Object& object);
+
+        static uint32_t Build_BVH_Node(std::vector<GPU_BVH_Node>& bvh_nodes, std::vector<BVH_Build_Node>& build_nodes, const std::vector<Object_Bounds>& object_bounds, uint32_t* object_indices_ptr, uint32_t object_count);
+        static void Link_BVH_Node(std::vector<GPU_BVH_Node>& bvh_nodes, const std::vector<BVH_Build_Node>& build_nodes, uint32_t direction_index, uint32_t node_index, uint32_t miss_index);
+
+        static void Convert_To_GPU_Voxels(const Voxel* voxels_ptr, GPU_Voxel* gpu_voxels_ptr, uint32_t voxel_count, uint32_t root_voxel_index);
+        static uint32_t Get_Voxel_Count(const Object& object);
+        static Voxel_Geometry Get_Voxel_Geometry(const Object& object, uint32_t voxel_index);
+        static Compact_Voxel Compress_Voxel(const Voxel& voxel);
+        static size_t Get_Object_Host_Memory_Usage(const Object& object);
+
+        static Object_Space_Volume Get_Object_Space_Volume(const Object_Transform& transform, const Overlap_Query& query);
+        static bool Volume_Box_Overlap(const Object_Space_Volume& volume, Vector_3<double> box_position, double box_size);
+        static bool Volume_Leaf_Overlap(const Object_Space_Volume& volume, const Voxel_Geometry& voxel);
+        static bool Volume_Octree_Overlap(const Object_Space_Volume& volume, const Object& object, uint32_t voxel_index);
+        static Overlap_Result Scene_Overlap(const std::vector<Object>& objects, const std::vector<Object_Transform>& transforms, const Overlap_Query& query);
+        static void Batch_Overlap_Worker_Thread(const std::vector<Object>* objects_ptr,
+                                                const std::vector<Object_Transform>* transforms_ptr,
+                                                const std::vector<Overlap_Query>* queries_ptr,
+                                                std::vector<Overlap_Result>* results_ptr,
+                                                uint32_t first_query_index,
+                                                uint32_t query_count);
+
+        static void Voxel_Sample_Volume_Function(Vector_3<double> voxel_position,
+                                                 double voxel_size,
+                                                 double step_size,
+                                                 uint32_t step_count,
+                                                 std::function<double(Vector_3<double>)> volume_sample_function,
+                                                 std::function<void(Vector_3<double>, double, double&, double&)> volume_bounds_function,
+                                                 const SDF_Graph* sdf_graph_ptr,
+                                                 std::vector<Vector_3<double>>& sample_positions,
+                                                 std::vector<double>& sample_distances,
+                                                 std::vector<double>& sample_scratch,
+                                                 bool& is_fully_contained,
+                                                 bool& is_intersecting);
+
+        static bool Voxel_Within_Plane_Error(Vector_3<double> voxel_position,
+                                             double voxel_size,
+                                             Vector_3<double> normal,
+                                             double plane_offset,
+                                             double normal_slope,
+                                             std::function<double(Vector_3<double>)> volume_sample_function,
+                                             double plane_error_tolerance);
 
         static void Object_From_Volume_Function_Worker_Thread(uint32_t max_depth,
                                                               std::vector<uint32_t> step_count_lookup_table,
                                                               double step_size,
+                                                              double plane_error_tolerance,
+                                                              uint32_t max_voxel_count,
                                                               uint32_t worker_index,
                                                               std::function<double(Vector_3<double>)> volume_sample_function,
+                                                              std::function<void(Vector_3<double>, double, double&, double&)> volume_bounds_function,
                                                               std::function<Vector_3<double>(Vector_3<double>, Vector_3<double>)> color_sample_function,
+                                                              const SDF_Graph* sdf_graph_ptr,
                                                               std::vector<Voxel>* voxels_ptr,
                                                               std::mutex* voxels_mutex_ptr,
+                                                              uint32_t* reserved_voxel_count_ptr,
+                                                              uint32_t* truncated_depth_ptr,
                                                               bool* work_complete_ptr,
                                                               std::mutex* work_complete_mutex_ptr,
                                                               uint32_t* active_workers_count_ptr,
@@ -123,13 +341,26 @@ namespace Cascade_Graphics
                                                               std::stack<uint32_t>* leaf_node_stack_ptr,
                                                               std::mutex* leaf_node_stack_mutex_ptr,
                                                               std::condition_variable* available_leaf_node_notify_ptr,
+                                                              std::vector<uint32_t>* deferred_voxels_ptr,
                                                               bool* work_available_ptr,
                                                               uint32_t* current_voxel_ptr,
                                                               std::mutex* data_mutex_ptr,
                                                               std::condition_variable* work_notify_ptr);
 
+        void Build_Object_From_Volume_Function(std::string label,
+                                               uint32_t max_depth,
+                                               Vector_3<double> sample_region_center,
+                                               double sample_region_size,
+                                               std::function<double(Vector_3<double>)> volume_sample_function,
+                                               std::function<void(Vector_3<double>, double, double&, double&)> volume_bounds_function,
+                                               std::function<Vector_3<double>(Vector_3<double>, Vector_3<double>)> color_sample_function,
+                                               const SDF_Graph* sdf_graph_ptr,
+                                               double plane_error_tolerance,
+                                               uint32_t max_voxel_count);
+
     public:
         Object_Manager();
+        ~Object_Manager();
 
     public:
         void Create_Object_From_Volume_Function(std::string label,
@@ -138,9 +369,44 @@ namespace Cascade_Graphics
                                                 double sample_region_size,
                                                 std::function<double(Vector_3<double>)> volume_sample_function,
                                                 std::function<Vector_3<double>(Vector_3<double>, Vector_3<double>)> color_sample_function);
+        void Create_Object_From_Volume_Function(std::string label,
+                                                uint32_t max_depth,
+                                                Vector_3<double> sample_region_center,
+                                                double sample_region_size,
+                                                std::function<double(Vector_3<double>)> volume_sample_function,
+                                                std::function<void(Vector_3<double>, double, double&, double&)> volume_bounds_function,
+                                                std::function<Vector_3<double>(Vector_3<double>, Vector_3<double>)> color_sample_function,
+                                                double plane_error_tolerance,
+                                                uint32_t max_voxel_count);
+        void Create_Object_From_SDF_Graph(std::string label,
+                                          uint32_t max_depth,
+                                          Vector_3<double> sample_region_center,
+                                          double sample_region_size,
+                                          const SDF_Graph& sdf_graph,
+                                          std::function<Vector_3<double>(Vector_3<double>, Vector_3<double>)> color_sample_function,
+                                          double plane_error_tolerance,
+                                          uint32_t max_voxel_count);
+        void Create_Object_From_GPU_Voxel_Range(std::string label, uint32_t root_voxel_index, uint32_t voxel_count, Vector_3<double> root_position, double root_size, uint32_t effective_depth);
+
+        Raycast_Hit Raycast(Vector_3<double> origin, Vector_3<double> direction, double max_distance);
+
+        Overlap_Result Point_Overlap(Vector_3<double> point);
+        Overlap_Result Sphere_Overlap(Vector_3<double> center, double radius);
+        Overlap_Result Box_Overlap(Vector_3<double> box_min, Vector_3<double> box_max);
+        Overlap_Result Overlap(Overlap_Query query);
+        std::vector<Overlap_Result> Batch_Overlap(const std::vector<Overlap_Query>& queries);
+
+        void Set_Voxel_Retention_Policy(std::string label, Voxel_Retention_Policy voxel_retention_policy);
+        void Apply_Voxel_Retention_Policies();
+        size_t Get_Host_Memory_Usage();
 
         Object* Get_Object(std::string label);
-        std::vector<GPU_Object> Get_GPU_Objects();
-        std::vector<GPU_Voxel> Get_GPU_Voxels();
+        uint32_t Get_Effective_Depth(std::string label);
+        size_t Get_Object_Count();
+        const std::vector<GPU_Object>& Get_GPU_Objects();
+        size_t Get_GPU_Voxel_Count();
+        const std::vector<GPU_BVH_Node>& Get_GPU_BVH_Nodes();
+        void Write_GPU_Objects(GPU_Object* destination_ptr, size_t first_object_index, size_t object_count);
+        void Write_GPU_Voxels(GPU_Voxel* destination_ptr, size_t first_voxel_index, size_t voxel_count);
     };
 } // namespace Cascade_Graphics
\ No newline at end of file
@@ -5,7 +5,8 @@
 
 namespace Cascade_Graphics
 {
-    Renderer::Renderer(std::shared_ptr<Vulkan_Backend::Vulkan_Graphics> vulkan_graphics_ptr, Window_Information window_information) : m_vulkan_graphics_ptr(vulkan_graphics_ptr), m_window_information(window_information)
+    Renderer::Renderer(std::shared_ptr<Vulkan_Backend::Vulkan_Graphics> vulkan_graphics_ptr, Window_Information window_information, Vulkan_Backend::Swapchain_Wrapper::Present_Policy present_policy, double target_frame_rate)
+        : m_present_policy(Get_Supported_Present_Policy(present_policy, target_frame_rate)), m_target_frame_rate(target_frame_rate), m_vulkan_graphics_ptr(vulkan_graphics_ptr), m_window_information(window_information)
     {
         std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
         m_vulkan_graphics_ptr->m_vulkan_object_access_notify.wait(vulkan_object_access_lock, [&] { return m_vulkan_graphics_ptr->Is_Vulkan_Initialized(); });
@@ -14,10 +15,11 @@ namespace Cascade_Graphics
 
         m_camera_ptr = std::make_shared<Camera>(Vector_3<double>(-3.0, 0.0, 0.0), Vector_3<double>(1.0, 0.0, 0.0));
         m_object_manager_ptr = std::make_shared<Object_Manager>();
+        m_gpu_octree_builder_ptr = std::make_shared<GPU_Octree_Builder>(m_vulkan_graphics_ptr, m_object_manager_ptr, this);
 
         m_surface_wrapper_ptr = std::make_shared<Vulkan_Backend::Surface_Wrapper>(m_vulkan_graphics_ptr->m_instance_wrapper_ptr, m_window_information);
         m_swapchain_wrapper_ptr = std::make_shared<Vulkan_Backend::Swapchain_Wrapper>(m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr, m_vulkan_graphics_ptr->m_physical_device_wrapper_ptr, m_surface_wrapper_ptr,
-                                                                                      m_vulkan_graphics_ptr->m_queue_manager_ptr, *m_window_information.width_ptr, *m_window_information.height_ptr);
+                                                                                      m_vulkan_graphics_ptr->m_queue_manager_ptr, *m_window_information.width_ptr, *m_window_information.height_ptr, m_present_policy);
 
         std::vector<Vulkan_Backend::Storage_Manager::Image_Resource> swapchain_image_resources = m_swapchain_wrapper_ptr->Get_Swapchain_Image_Resources();
         for (uint32_t i = 0; i < swapchain_image_resources.size(); i++)
@@ -28,34 +30,56 @@ namespace Cascade_Graphics
         m_render_target_image_identifier
             = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Image("render_target", swapchain_image_resources.front().image_format, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
                                                                          m_swapchain_wrapper_ptr->Get_Swapchain_Extent(), Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE | Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
-        m_camera_data_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("camera_data", sizeof(Camera::GPU_Camera_Data), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+        m_beam_image_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Image("beam_distances", VK_FORMAT_R32_SFLOAT, VK_IMAGE_USAGE_STORAGE_BIT, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, Get_Beam_Extent(),
+                                                                                            Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE);
+        m_output_image_identifier
+            = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Image("output_image", swapchain_image_resources.front().image_format, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                                                                         m_swapchain_wrapper_ptr->Get_Swapchain_Extent(), Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE | Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
+        m_camera_data_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("camera_data", sizeof(Camera::GPU_Camera_Data), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
                                                                                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                                                                                                Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE | Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
         m_object_buffer_identifier
-            = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("object_buffer", sizeof(Object_Manager::GPU_Object), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-                                                                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE | Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
+            = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("object_buffer", sizeof(Object_Manager::GPU_Object), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                                          VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE | Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
         m_voxel_buffer_identifier
-            = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("voxel_buffer", sizeof(Object_Manager::GPU_Voxel), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-                                                                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE | Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
-        m_hit_buffer_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("hit_buffer", sizeof(uint32_t) * 4, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                                                                              Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE);
-        m_staging_buffer_identifier
-            = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("staging_buffer", 0, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-                                                                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
+            = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("voxel_buffer", sizeof(Object_Manager::GPU_Voxel), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                                          VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE | Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
+        m_hit_buffer_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("hit_buffer", sizeof(uint32_t) * 4 * m_hit_buffer_slot_count, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                                                              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE);
+        m_bvh_buffer_identifier
+            = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("bvh_buffer", sizeof(Object_Manager::GPU_BVH_Node), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                                          VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE | Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
+        m_depth_buffer_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("depth_buffer", sizeof(float) * 2 * Get_Pixel_Count(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                                                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE);
+        m_reprojection_buffer_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("reprojection_buffer", sizeof(uint32_t) * Get_Pixel_Count(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                                                                       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE);
 
         m_swapchain_resource_grouping_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Resource_Grouping("swapchain_resource_grouping", m_swapchain_image_identifiers);
         m_render_compute_resource_grouping_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Resource_Grouping(
-            "render_compute_resource_grouping", {m_render_target_image_identifier, m_camera_data_identifier, m_object_buffer_identifier, m_voxel_buffer_identifier, m_hit_buffer_identifier});
+            "render_compute_resource_grouping", {m_render_target_image_identifier, m_beam_image_identifier, m_output_image_identifier, m_camera_data_identifier, m_object_buffer_identifier, m_voxel_buffer_identifier, m_hit_buffer_identifier, m_bvh_buffer_identifier, m_depth_buffer_identifier, m_reprojection_buffer_identifier});
         m_render_compute_descriptor_set_identifier = m_vulkan_graphics_ptr->m_descriptor_set_manager_ptr->Create_Descriptor_Set(m_render_compute_resource_grouping_identifier);
+        m_direct_swapchain_rendering = m_swapchain_wrapper_ptr->Is_Storage_Usage_Supported();
+        Create_Swapchain_Render_Descriptor_Sets();
 
         m_render_shader_identifier = m_vulkan_graphics_ptr->m_shader_manager_ptr->Add_Shader("render_shader", "../lib/Cascade_Graphics/src/Shaders/render.comp");
+        m_beam_shader_identifier = m_vulkan_graphics_ptr->m_shader_manager_ptr->Add_Shader("beam_shader", "../lib/Cascade_Graphics/src/Shaders/beam.comp");
+        m_reproject_shader_identifier = m_vulkan_graphics_ptr->m_shader_manager_ptr->Add_Shader("reproject_shader", "../lib/Cascade_Graphics/src/Shaders/reproject.comp");
+        m_upscale_shader_identifier = m_vulkan_graphics_ptr->m_shader_manager_ptr->Add_Shader("upscale_shader", "../lib/Cascade_Graphics/src/Shaders/upscale.comp");
 
-        m_render_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("render_pipeline", m_render_compute_descriptor_set_identifier, m_render_shader_identifier);
+        Load_Render_Pipeline_Configuration();
+
+        m_render_pipeline_identifier = Create_Render_Pipeline(m_render_pipeline_configuration);
+        m_beam_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("beam_pipeline", m_render_compute_descriptor_set_identifier, m_beam_shader_identifier);
+        m_reproject_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("reproject_pipeline", m_render_compute_descriptor_set_identifier, m_reproject_shader_identifier);
+        m_upscale_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("upscale_pipeline", m_render_compute_descriptor_set_identifier, m_upscale_shader_identifier);
+
+        m_frame_timestamps_supported
+            = m_vulkan_graphics_ptr->m_query_manager_ptr->Are_Timestamps_Supported(m_vulkan_graphics_ptr->m_queue_manager_ptr->Get_Queue_Family_Index(Vulkan_Backend::Queue_Manager::Queue_Types::COMPUTE_QUEUE));
+        Create_Frame_Resources();
         Record_Command_Buffers();
 
-        m_image_available_semaphore_identifier = m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Create_Semaphore("image_available_semaphore");
-        m_render_finished_semaphore_identifier = m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Create_Semaphore("render_finished_semaphore");
-        m_in_flight_fence_identifier = m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Create_Fence("in_flight_fence");
+        // Counts submitted frames so uploads can wait for the frames still reading a buffer on the GPU
+        m_render_timeline_semaphore_identifier = m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Create_Timeline_Semaphore("render_timeline_semaphore", m_render_timeline_value);
 
         LOG_DEBUG << "Graphics: Finished creating renderer";
 
@@ -73,26 +97,506 @@ namespace Cascade_Graphics
         LOG_DEBUG << "Graphics: Finished destroying renderer";
     }
 
+    VkExtent2D Renderer::Get_Beam_Extent()
+    {
+        VkExtent2D beam_extent = {};
+        beam_extent.width = (m_swapchain_wrapper_ptr->Get_Swapchain_Extent().width + 7) / 8;
+        beam_extent.height = (m_swapchain_wrapper_ptr->Get_Swapchain_Extent().height + 7) / 8;
+
+        return beam_extent;
+    }
+
+    Vulkan_Backend::Swapchain_Wrapper::Present_Policy Renderer::Get_Supported_Present_Policy(Vulkan_Backend::Swapchain_Wrapper::Present_Policy present_policy, double target_frame_rate)
+    {
+        if (present_policy == Vulkan_Backend::Swapchain_Wrapper::Present_Policy::TARGET_FRAME_RATE && !(std::isfinite(target_frame_rate) && target_frame_rate > 0.0))
+        {
+            LOG_WARN << "Graphics: A target frame rate of " << target_frame_rate << " can't be paced, falling back to vsync";
+            return Vulkan_Backend::Swapchain_Wrapper::Present_Policy::VSYNC;
+        }
+
+        return present_policy;
+    }
+
+    size_t Renderer::Get_Pixel_Count()
+    {
+        return static_cast<size_t>(m_swapchain_wrapper_ptr->Get_Swapchain_Extent().width) * m_swapchain_wrapper_ptr->Get_Swapchain_Extent().height;
+    }
+
+    VkExtent2D Renderer::Get_Render_Extent()
+    {
+        VkExtent2D render_extent = {};
+        render_extent.width = std::max(1u, static_cast<uint32_t>(m_swapchain_wrapper_ptr->Get_Swapchain_Extent().width * m_render_scale));
+        render_extent.height = std::max(1u, static_cast<uint32_t>(m_swapchain_wrapper_ptr->Get_Swapchain_Extent().height * m_render_scale));
+
+        return render_extent;
+    }
+
+    void Renderer::Update_Render_Scale(double gpu_frame_time)
+    {
+        if (gpu_frame_time <= 0.0)
+        {
+            return;
+        }
+
+        // Traversal cost grows with the pixel count, so the scale that would hit the target goes with the square root of the time ratio
+        double ideal_render_scale = m_render_scale * std::sqrt(m_target_frame_time / gpu_frame_time);
+
+        // Only move part of the way per frame so a single slow frame doesn't cause a visible jump
+        double render_scale = std::clamp(m_render_scale + (ideal_render_scale - m_render_scale) * 0.2, m_minimum_render_scale, 1.0);
+        if (std::abs(render_scale - m_render_scale) > 0.01 || render_scale == 1.0 || render_scale == m_minimum_render_scale)
+        {
+            m_render_scale = render_scale;
+        }
+    }
+
+    uint32_t Renderer::Get_Frame_Timestamp_Count()
+    {
+        // One timestamp before the first pass and one after every pass
+        return FRAME_PASS_COUNT + 1;
+    }
+
+    void Renderer::Write_Frame_Timestamp(uint32_t command_buffer_index, uint32_t timestamp_index, VkPipelineStageFlagBits pipeline_stage)
+    {
+        if (m_frame_timestamps_supported)
+        {
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Write_Timestamp(m_command_buffer_identifiers[command_buffer_index], *m_vulkan_graphics_ptr->m_query_manager_ptr->Get_Query_Pool(m_frame_timestamp_query_pool_identifier),
+                                                                                 pipeline_stage, Get_Frame_Timestamp_Count() * command_buffer_index + timestamp_index);
+        }
+    }
+
+    void Renderer::Resolve_Frame_Timestamps()
+    {
+        // Passes left out of the recording only have back to back timestamps, so they would just add zeros
+        bool frame_pass_recorded[FRAME_PASS_COUNT] = {true, m_temporal_reprojection_enabled, m_beam_prepass_enabled, true, m_dynamic_resolution_enabled, true};
+
+        std::vector<double> frame_timestamps(Get_Frame_Timestamp_Count());
+        for (uint32_t i = 0; i < m_pending_frame_timestamp_command_buffer_indices.size();)
+        {
+            // Results are read without waiting, submissions that haven't finished yet are tried again next frame
+            if (!m_vulkan_graphics_ptr->m_query_manager_ptr->Get_Timestamps(m_frame_timestamp_query_pool_identifier, Get_Frame_Timestamp_Count() * m_pending_frame_timestamp_command_buffer_indices[i], Get_Frame_Timestamp_Count(),
+                                                                             frame_timestamps.data()))
+            {
+                i++;
+                continue;
+            }
+            m_pending_frame_timestamp_command_buffer_indices.erase(m_pending_frame_timestamp_command_buffer_indices.begin() + i);
+
+            for (uint32_t j = 0; j < FRAME_PASS_COUNT; j++)
+            {
+                if (frame_pass_recorded[j])
+                {
+                    m_frame_pass_time_samples[j].push_back((frame_timestamps[j + 1] - frame_timestamps[j]) / 1000000.0);
+                }
+            }
+
+            double gpu_frame_time = (frame_timestamps.back() - frame_timestamps.front()) / 1000000.0;
+            m_frame_pass_time_samples[FRAME_PASS_COUNT].push_back(gpu_frame_time);
+
+            for (uint32_t j = 0; j < m_frame_pass_time_samples.size(); j++)
+            {
+                while (m_frame_pass_time_samples[j].size() > m_frame_pass_time_window)
+                {
+                    m_frame_pass_time_samples[j].pop_front();
+                }
+            }
+
+            if (m_dynamic_resolution_enabled)
+            {
+                Update_Render_Scale(gpu_frame_time);
+            }
+        }
+    }
+
+    Vulkan_Backend::Identifier Renderer::Create_Render_Pipeline(Render_Pipeline_Configuration configuration)
+    {
+        return m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("render_pipeline", m_render_compute_descriptor_set_identifier, m_render_shader_identifier,
+                                                                                   {configuration.workgroup_width, configuration.workgroup_height, configuration.max_iterations});
+    }
+
+    std::string Renderer::Get_Device_Tuning_Key()
+    {
+        VkPhysicalDeviceProperties physical_device_properties;
+        vkGetPhysicalDeviceProperties(*m_vulkan_graphics_ptr->m_physical_device_wrapper_ptr->Get_Physical_Device(), &physical_device_properties);
+
+        // A driver update can change which configuration is fastest, so it gets its own entry
+        std::stringstream device_tuning_key;
+        device_tuning_key << std::hex << physical_device_properties.vendorID << ":" << physical_device_properties.deviceID << ":" << physical_device_properties.driverVersion;
+
+        return device_tuning_key.str();
+    }
+
+    bool Renderer::Render_Pipeline_Configuration_Supported(Render_Pipeline_Configuration configuration)
+    {
+        VkPhysicalDeviceProperties physical_device_properties;
+        vkGetPhysicalDeviceProperties(*m_vulkan_graphics_ptr->m_physical_device_wrapper_ptr->Get_Physical_Device(), &physical_device_properties);
+
+        // Checked one dimension at a time so a huge width or height can't overflow the product
+        return configuration.workgroup_width > 0 && configuration.workgroup_height > 0 && configuration.max_iterations > 0 && configuration.workgroup_width <= physical_device_properties.limits.maxComputeWorkGroupSize[0]
+               && configuration.workgroup_height <= physical_device_properties.limits.maxComputeWorkGroupSize[1]
+               && configuration.workgroup_width <= physical_device_properties.limits.maxComputeWorkGroupInvocations / configuration.workgroup_height;
+    }
+
+    void Renderer::Load_Render_Pipeline_Configuration()
+    {
+        std::string device_tuning_key = Get_Device_Tuning_Key();
+        std::ifstream tuning_file(m_render_pipeline_tuning_path);
+
+        std::string line;
+        while (std::getline(tuning_file, line))
+        {
+            std::stringstream line_stream(line);
+            std::string key;
+            Render_Pipeline_Configuration configuration = {};
+
+            if (line_stream >> key >> configuration.workgroup_width >> configuration.workgroup_height >> configuration.max_iterations && key == device_tuning_key)
+            {
+                // The file may have been edited by hand or written for a driver with different limits
+                if (!Render_Pipeline_Configuration_Supported(configuration))
+                {
+                    LOG_WARN << "Graphics: Ignoring tuned render workgroup size " << configuration.workgroup_width << "x" << configuration.workgroup_height << " with " << configuration.max_iterations
+                             << " max iterations, the device doesn't support it. Using the default configuration";
+                    return;
+                }
+
+                LOG_INFO << "Graphics: Using tuned render workgroup size " << configuration.workgroup_width << "x" << configuration.workgroup_height;
+
+                m_render_pipeline_configuration = configuration;
+                return;
+            }
+        }
+    }
+
+    void Renderer::Save_Render_Pipeline_Configuration()
+    {
+        std::string device_tuning_key = Get_Device_Tuning_Key();
+        std::vector<std::string> lines;
+
+        // Keep the entries of every other device
+        std::ifstream existing_tuning_file(m_render_pipeline_tuning_path);
+        std::string line;
+        while (std::getline(existing_tuning_file, line))
+        {
+            std::stringstream line_stream(line);
+            std::string key;
+            if (line_stream >> key && key != device_tuning_key)
+            {
+                lines.push_back(line);
+            }
+        }
+        existing_tuning_file.close();
+
+        std::stringstream device_line;
+        device_line << device_tuning_key << " " << m_render_pipeline_configuration.workgroup_width << " " << m_render_pipeline_configuration.workgroup_height << " " << m_render_pipeline_configuration.max_iterations;
+        lines.push_back(device_line.str());
+
+        std::ofstream tuning_file(m_render_pipeline_tuning_path, std::ios::trunc);
+        if (!tuning_file)
+        {
+            LOG_WARN << "Graphics: Failed to write render pipeline tuning to " << m_render_pipeline_tuning_path;
+            return;
+        }
+
+        for (uint32_t i = 0; i < lines.size(); i++)
+        {
+            tuning_file << lines[i] << "\n";
+        }
+    }
+
+    double Renderer::Time_Render_Pipeline(Render_Pipeline_Configuration configuration)
+    {
+        const uint32_t timed_dispatch_count = 4;
+
+        Vulkan_Backend::Identifier pipeline_identifier = Create_Render_Pipeline(configuration);
+        Vulkan_Backend::Identifier query_pool_identifier = m_vulkan_graphics_ptr->m_query_manager_ptr->Create_Timestamp_Query_Pool("render_tuning_query_pool", 2);
+        Vulkan_Backend::Identifier fence_identifier = m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Create_Fence("render_tuning_fence");
+        Vulkan_Backend::Identifier command_buffer_identifier = m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Add_Command_Buffer(
+            "render_tuning_command_buffer", m_vulkan_graphics_ptr->m_queue_manager_ptr->Get_Queue_Family_Index(Vulkan_Backend::Queue_Manager::Queue_Types::COMPUTE_QUEUE), {m_render_compute_resource_grouping_identifier}, pipeline_identifier);
+
+        VkQueryPool query_pool = *m_vulkan_graphics_ptr->m_query_manager_ptr->Get_Query_Pool(query_pool_identifier);
+        uint32_t group_count_x = static_cast<uint32_t>(std::ceil(m_swapchain_wrapper_ptr->Get_Swapchain_Extent().width / static_cast<double>(configuration.workgroup_width)));
+        uint32_t group_count_y = static_cast<uint32_t>(std::ceil(m_swapchain_wrapper_ptr->Get_Swapchain_Extent().height / static_cast<double>(configuration.workgroup_height)));
+
+        m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Begin_Recording(command_buffer_identifier, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Reset_Queries(command_buffer_identifier, query_pool, 0, 2);
+        m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Image_Memory_Barrier(command_buffer_identifier, m_render_target_image_identifier, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+        // The first dispatch only warms up caches and isn't timed
+        m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Dispatch_Compute_Shader(command_buffer_identifier, group_count_x, group_count_y, 1);
+        m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Memory_Barrier(command_buffer_identifier, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                                                            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Write_Timestamp(command_buffer_identifier, query_pool, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0);
+        for (uint32_t i = 0; i < timed_dispatch_count; i++)
+        {
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Dispatch_Compute_Shader(command_buffer_identifier, group_count_x, group_count_y, 1);
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Memory_Barrier(command_buffer_identifier, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                                                                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        }
+        m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Write_Timestamp(command_buffer_identifier, query_pool, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 1);
+        m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->End_Recording(command_buffer_identifier);
+
+        VkSubmitInfo submit_info = {};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.pNext = nullptr;
+        submit_info.waitSemaphoreCount = 0;
+        submit_info.pWaitSemaphores = nullptr;
+        submit_info.pWaitDstStageMask = nullptr;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Get_Command_Buffer(command_buffer_identifier);
+        submit_info.signalSemaphoreCount = 0;
+        submit_info.pSignalSemaphores = nullptr;
+
+        VALIDATE_VKRESULT(vkResetFences(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device(), 1, m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Fence(fence_identifier)), "Graphics: Failed to reset fence");
+        VALIDATE_VKRESULT(vkQueueSubmit(*m_vulkan_graphics_ptr->m_queue_manager_ptr->Get_Queue(Vulkan_Backend::Queue_Manager::Queue_Types::COMPUTE_QUEUE), 1, &submit_info, *m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Fence(fence_identifier)),
+                          "Graphics: Failed to submit render tuning command buffer");
+        VALIDATE_VKRESULT(vkWaitForFences(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device(), 1, m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Fence(fence_identifier), VK_TRUE, UINT64_MAX),
+                          "Graphics: Failed to wait for fence");
+
+        double dispatch_time = std::numeric_limits<double>::infinity();
+        double timestamps[2];
+        if (m_vulkan_graphics_ptr->m_query_manager_ptr->Get_Timestamps(query_pool_identifier, 0, 2, timestamps))
+        {
+            dispatch_time = (timestamps[1] - timestamps[0]) / 1000000.0 / timed_dispatch_count;
+        }
+
+        m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Remove_Command_Buffer(command_buffer_identifier);
+        m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Destroy_Fence(fence_identifier);
+        m_vulkan_graphics_ptr->m_query_manager_ptr->Destroy_Query_Pool(query_pool_identifier);
+        m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(pipeline_identifier);
+
+        return dispatch_time;
+    }
+
+    void Renderer::Read_Traversal_Statistics(uint32_t frame_index)
+    {
+        if (m_frame_resources[frame_index].traversal_statistics_pending)
+        {
+            uint32_t slot_counters[4];
+            m_vulkan_graphics_ptr->m_storage_manager_ptr->Download_From_Buffer_Direct(m_hit_buffer_identifier, slot_counters, sizeof(slot_counters), sizeof(slot_counters) * m_frame_resources[frame_index].traversal_statistics_slot);
+
+            m_traversal_statistics = {};
+            m_traversal_statistics.traversal_step_count = (static_cast<uint64_t>(slot_counters[1]) << 32) | slot_counters[0];
+            m_traversal_statistics.leaf_test_count = slot_counters[2];
+            m_traversal_statistics.hit_count = slot_counters[3];
+            m_traversal_statistics.ray_count = m_frame_resources[frame_index].traversal_ray_count;
+
+            m_frame_resources[frame_index].traversal_statistics_pending = false;
+        }
+
+        // The shader only ever adds, so the slot the next frame writes has to start at zero. Only that slot is written since frames still in flight are adding to the others
+        uint32_t zero_counters[4] = {};
+        m_vulkan_graphics_ptr->m_storage_manager_ptr->Upload_To_Buffer_Direct(m_hit_buffer_identifier, zero_counters, sizeof(zero_counters), sizeof(zero_counters) * which_hit_buffer);
+    }
+
+    void Renderer::Create_Frame_Resources()
+    {
+        m_frame_resources.resize(m_frames_in_flight);
+        for (uint32_t i = 0; i < m_frames_in_flight; i++)
+        {
+            m_frame_resources[i] = {};
+            m_frame_resources[i].image_available_semaphore_identifier = m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Create_Semaphore("image_available_semaphore");
+            m_frame_resources[i].in_flight_fence_identifier = m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Create_Fence("in_flight_fence");
+        }
+        m_frame_index = 0;
+
+        // Presentation holds on to its wait semaphore until the image is acquired again, so these belong to the swapchain images rather than the frames in flight
+        m_render_finished_semaphore_identifiers.resize(m_swapchain_wrapper_ptr->Get_Swapchain_Image_Count());
+        for (uint32_t i = 0; i < m_render_finished_semaphore_identifiers.size(); i++)
+        {
+            m_render_finished_semaphore_identifiers[i] = m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Create_Semaphore("render_finished_semaphore");
+        }
+
+        // Each frame in flight writes its camera to its own slot, which its command buffers copy into the uniform buffer once the previous frame is done reading it
+        m_camera_upload_buffer_identifier
+            = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("camera_upload_buffer", sizeof(Camera::GPU_Camera_Data) * m_frames_in_flight, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE);
+
+        // Command buffers are recorded per frame in flight and swapchain image, each with its own range of queries
+        m_frame_timestamp_query_pool_identifier = m_vulkan_graphics_ptr->m_query_manager_ptr->Create_Timestamp_Query_Pool("frame_timestamp_query_pool",
+                                                                                                                          Get_Frame_Timestamp_Count() * m_frames_in_flight * m_swapchain_wrapper_ptr->Get_Swapchain_Image_Count());
+    }
+
+    void Renderer::Destroy_Frame_Resources()
+    {
+        for (uint32_t i = 0; i < m_frame_resources.size(); i++)
+        {
+            m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Destroy_Semaphore(m_frame_resources[i].image_available_semaphore_identifier);
+            m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Destroy_Fence(m_frame_resources[i].in_flight_fence_identifier);
+        }
+        m_frame_resources.clear();
+
+        for (uint32_t i = 0; i < m_render_finished_semaphore_identifiers.size(); i++)
+        {
+            m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Destroy_Semaphore(m_render_finished_semaphore_identifiers[i]);
+        }
+        m_render_finished_semaphore_identifiers.clear();
+
+        m_vulkan_graphics_ptr->m_storage_manager_ptr->Destroy_Buffer(m_camera_upload_buffer_identifier);
+        m_vulkan_graphics_ptr->m_query_manager_ptr->Destroy_Query_Pool(m_frame_timestamp_query_pool_identifier);
+    }
+
+    void Renderer::Create_Swapchain_Render_Descriptor_Sets()
+    {
+        if (!m_direct_swapchain_rendering)
+        {
+            return;
+        }
+
+        for (uint32_t i = 0; i < m_swapchain_image_identifiers.size(); i++)
+        {
+            // The swapchain image takes the binding of the last pass's output, keeping the layout the pipelines were created with
+            Vulkan_Backend::Identifier render_target_image_identifier = m_dynamic_resolution_enabled ? m_render_target_image_identifier : m_swapchain_image_identifiers[i];
+            Vulkan_Backend::Identifier output_image_identifier = m_dynamic_resolution_enabled ? m_swapchain_image_identifiers[i] : m_output_image_identifier;
+
+            m_swapchain_render_resource_grouping_identifiers.push_back(m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Resource_Grouping(
+                "swapchain_render_resource_grouping", {render_target_image_identifier, m_beam_image_identifier, output_image_identifier, m_camera_data_identifier, m_object_buffer_identifier, m_voxel_buffer_identifier, m_hit_buffer_identifier, m_bvh_buffer_identifier, m_depth_buffer_identifier, m_reprojection_buffer_identifier}));
+            m_swapchain_render_descriptor_set_identifiers.push_back(m_vulkan_graphics_ptr->m_descriptor_set_manager_ptr->Create_Descriptor_Set(m_swapchain_render_resource_grouping_identifiers.back()));
+        }
+    }
+
+    void Renderer::Destroy_Swapchain_Render_Descriptor_Sets()
+    {
+        for (uint32_t i = 0; i < m_swapchain_render_descriptor_set_identifiers.size(); i++)
+        {
+            m_vulkan_graphics_ptr->m_descriptor_set_manager_ptr->Remove_Descriptor_Set(m_swapchain_render_descriptor_set_identifiers[i]);
+            m_vulkan_graphics_ptr->m_storage_manager_ptr->Remove_Resource_Grouping(m_swapchain_render_resource_grouping_identifiers[i]);
+        }
+        m_swapchain_render_descriptor_set_identifiers.clear();
+        m_swapchain_render_resource_grouping_identifiers.clear();
+    }
+
     void Renderer::Record_Command_Buffers()
     {
-        for (uint32_t i = 0; i < m_swapchain_wrapper_ptr->Get_Swapchain_Image_Count(); i++)
+        // Re-recording happens with the device idle, and the new command buffers reset the queries of the old ones
+        m_pending_frame_timestamp_command_buffer_indices.clear();
+
+        for (uint32_t i = 0; i < m_frames_in_flight * m_swapchain_wrapper_ptr->Get_Swapchain_Image_Count(); i++)
         {
-            m_command_buffer_identifiers.push_back(m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Add_Command_Buffer("render_frame_command_buffer",
-                                                                                                                           m_vulkan_graphics_ptr->m_queue_manager_ptr->Get_Queue_Family_Index(Vulkan_Backend::Queue_Manager::Queue_Types::COMPUTE_QUEUE),
-                                                                                                                           {m_swapchain_resource_grouping_identifier, m_render_compute_resource_grouping_identifier}, m_render_pipeline_identifier));
+            uint32_t frame_index = i / m_swapchain_wrapper_ptr->Get_Swapchain_Image_Count();
+            uint32_t image_index = i % m_swapchain_wrapper_ptr->Get_Swapchain_Image_Count();
+
+            Vulkan_Backend::Identifier render_target_image_identifier = m_render_target_image_identifier;
+            Vulkan_Backend::Identifier output_image_identifier = m_output_image_identifier;
+            std::vector<Vulkan_Backend::Identifier> resource_grouping_identifiers = {m_swapchain_resource_grouping_identifier, m_render_compute_resource_grouping_identifier};
+
+            // Without a copy the last pass writes straight into the swapchain image through that image's own descriptor set
+            if (m_direct_swapchain_rendering)
+            {
+                if (m_dynamic_resolution_enabled)
+                {
+                    output_image_identifier = m_swapchain_image_identifiers[image_index];
+                }
+                else
+                {
+                    render_target_image_identifier = m_swapchain_image_identifiers[image_index];
+                }
+                resource_grouping_identifiers = {m_swapchain_render_resource_grouping_identifiers[image_index]};
+            }
+
+            m_command_buffer_identifiers.push_back(m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Add_Command_Buffer(
+                "render_frame_command_buffer", m_vulkan_graphics_ptr->m_queue_manager_ptr->Get_Queue_Family_Index(Vulkan_Backend::Queue_Manager::Queue_Types::COMPUTE_QUEUE), resource_grouping_identifiers, m_render_pipeline_identifier));
 
             m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Begin_Recording(m_command_buffer_identifiers[i], (VkCommandBufferUsageFlagBits)0);
-            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Image_Memory_Barrier(m_command_buffer_identifiers[i], m_swapchain_image_identifiers[i], VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                                                                      VK_PIPELINE_STAGE_TRANSFER_BIT);
-            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Image_Memory_Barrier(m_command_buffer_identifiers[i], m_render_target_image_identifier, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
-            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Dispatch_Compute_Shader(m_command_buffer_identifiers[i], static_cast<uint32_t>(std::ceil(m_swapchain_wrapper_ptr->Get_Swapchain_Extent().width / 32.0)),
-                                                                                         static_cast<uint32_t>(std::ceil(m_swapchain_wrapper_ptr->Get_Swapchain_Extent().height / 32.0)), 1);
-            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Image_Memory_Barrier(m_command_buffer_identifiers[i], m_render_target_image_identifier, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                                                                                      VK_PIPELINE_STAGE_TRANSFER_BIT);
-            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Copy_Image(m_command_buffer_identifiers[i], m_render_target_image_identifier, m_swapchain_image_identifiers[i], m_swapchain_wrapper_ptr->Get_Swapchain_Extent().width,
-                                                                            m_swapchain_wrapper_ptr->Get_Swapchain_Extent().height);
-            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Image_Memory_Barrier(m_command_buffer_identifiers[i], m_render_target_image_identifier, VK_ACCESS_NONE, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_TRANSFER_BIT);
-            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Image_Memory_Barrier(m_command_buffer_identifiers[i], m_swapchain_image_identifiers[i], VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_TRANSFER_BIT);
+            if (m_frame_timestamps_supported)
+            {
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Reset_Queries(m_command_buffer_identifiers[i], *m_vulkan_graphics_ptr->m_query_manager_ptr->Get_Query_Pool(m_frame_timestamp_query_pool_identifier),
+                                                                                   Get_Frame_Timestamp_Count() * i, Get_Frame_Timestamp_Count());
+            }
+            Write_Frame_Timestamp(i, 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+
+            // The previous frame may still be running, so wait for its passes before reusing the shared buffers and images
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Memory_Barrier(m_command_buffer_identifiers[i], VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+                                                                                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+                                                                                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT);
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Copy_Buffer(m_command_buffer_identifiers[i], m_camera_upload_buffer_identifier, m_camera_data_identifier, sizeof(Camera::GPU_Camera_Data) * frame_index, 0,
+                                                                             sizeof(Camera::GPU_Camera_Data));
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Memory_Barrier(m_command_buffer_identifiers[i], VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_UNIFORM_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+            // The swapchain image is only ready once the acquire semaphore wait at the compute stage is done
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Set_Image_Initial_Usage(m_command_buffer_identifiers[i], m_swapchain_image_identifiers[image_index], 0, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+            if (render_target_image_identifier == m_render_target_image_identifier)
+            {
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Set_Image_Initial_Usage(m_command_buffer_identifiers[i], m_render_target_image_identifier, VK_ACCESS_SHADER_WRITE_BIT,
+                                                                                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT);
+            }
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Set_Image_Initial_Usage(m_command_buffer_identifiers[i], m_beam_image_identifier, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+            if (output_image_identifier == m_output_image_identifier)
+            {
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Set_Image_Initial_Usage(m_command_buffer_identifiers[i], m_output_image_identifier, VK_ACCESS_SHADER_WRITE_BIT,
+                                                                                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT);
+            }
+
+            if (!m_direct_swapchain_rendering)
+            {
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Image_Memory_Barrier(m_command_buffer_identifiers[i], m_swapchain_image_identifiers[image_index], VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                                                          VK_PIPELINE_STAGE_TRANSFER_BIT);
+            }
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Image_Memory_Barrier(m_command_buffer_identifiers[i], render_target_image_identifier, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+            Write_Frame_Timestamp(i, LAYOUT_TRANSITION_PASS + 1, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+            // Dispatches cover the whole swapchain and the shaders skip anything outside the render extent, so the render scale can change without re-recording
+            if (m_temporal_reprojection_enabled)
+            {
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Memory_Barrier(m_command_buffer_identifiers[i], VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                                                                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Bind_Compute_Pipeline(m_command_buffer_identifiers[i], m_reproject_pipeline_identifier);
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Dispatch_Compute_Shader(m_command_buffer_identifiers[i], static_cast<uint32_t>(std::ceil(m_swapchain_wrapper_ptr->Get_Swapchain_Extent().width / 32.0)),
+                                                                                             static_cast<uint32_t>(std::ceil(m_swapchain_wrapper_ptr->Get_Swapchain_Extent().height / 32.0)), 1);
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Memory_Barrier(m_command_buffer_identifiers[i], VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                                                                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+            }
+            Write_Frame_Timestamp(i, REPROJECTION_PASS + 1, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+            if (m_beam_prepass_enabled)
+            {
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Image_Memory_Barrier(m_command_buffer_identifiers[i], m_beam_image_identifier, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Bind_Compute_Pipeline(m_command_buffer_identifiers[i], m_beam_pipeline_identifier);
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Dispatch_Compute_Shader(m_command_buffer_identifiers[i], static_cast<uint32_t>(std::ceil(Get_Beam_Extent().width / 8.0)),
+                                                                                             static_cast<uint32_t>(std::ceil(Get_Beam_Extent().height / 8.0)), 1);
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Image_Memory_Barrier(m_command_buffer_identifiers[i], m_beam_image_identifier, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+            }
+            Write_Frame_Timestamp(i, BEAM_PREPASS + 1, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+            if (m_temporal_reprojection_enabled || m_beam_prepass_enabled)
+            {
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Bind_Compute_Pipeline(m_command_buffer_identifiers[i], m_render_pipeline_identifier);
+            }
+
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Dispatch_Compute_Shader(
+                m_command_buffer_identifiers[i], static_cast<uint32_t>(std::ceil(m_swapchain_wrapper_ptr->Get_Swapchain_Extent().width / static_cast<double>(m_render_pipeline_configuration.workgroup_width))),
+                static_cast<uint32_t>(std::ceil(m_swapchain_wrapper_ptr->Get_Swapchain_Extent().height / static_cast<double>(m_render_pipeline_configuration.workgroup_height))), 1);
+            Write_Frame_Timestamp(i, RENDER_PASS + 1, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+            // Scale the rendered region up to the swapchain size, otherwise the render target already matches it
+            Vulkan_Backend::Identifier present_source_image_identifier = render_target_image_identifier;
+            if (m_dynamic_resolution_enabled)
+            {
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Image_Memory_Barrier(m_command_buffer_identifiers[i], render_target_image_identifier, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Image_Memory_Barrier(m_command_buffer_identifiers[i], output_image_identifier, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Bind_Compute_Pipeline(m_command_buffer_identifiers[i], m_upscale_pipeline_identifier);
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Dispatch_Compute_Shader(m_command_buffer_identifiers[i], static_cast<uint32_t>(std::ceil(m_swapchain_wrapper_ptr->Get_Swapchain_Extent().width / 32.0)),
+                                                                                             static_cast<uint32_t>(std::ceil(m_swapchain_wrapper_ptr->Get_Swapchain_Extent().height / 32.0)), 1);
+                present_source_image_identifier = output_image_identifier;
+            }
+            Write_Frame_Timestamp(i, UPSCALE_PASS + 1, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+            if (m_direct_swapchain_rendering)
+            {
+                // Presentation waits on the semaphore, so the transition has no access of its own to make visible
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Image_Memory_Barrier(m_command_buffer_identifiers[i], m_swapchain_image_identifiers[image_index], VK_ACCESS_NONE, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                                                                                          VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+            }
+            else
+            {
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Image_Memory_Barrier(m_command_buffer_identifiers[i], present_source_image_identifier, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                                                                          VK_PIPELINE_STAGE_TRANSFER_BIT);
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Copy_Image(m_command_buffer_identifiers[i], present_source_image_identifier, m_swapchain_image_identifiers[image_index],
+                                                                                m_swapchain_wrapper_ptr->Get_Swapchain_Extent().width, m_swapchain_wrapper_ptr->Get_Swapchain_Extent().height);
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Image_Memory_Barrier(m_command_buffer_identifiers[i], present_source_image_identifier, VK_ACCESS_NONE, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_TRANSFER_BIT);
+                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Image_Memory_Barrier(m_command_buffer_identifiers[i], m_swapchain_image_identifiers[image_index], VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                                                                                          VK_PIPELINE_STAGE_TRANSFER_BIT);
+            }
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Memory_Barrier(m_command_buffer_identifiers[i], VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
+            Write_Frame_Timestamp(i, PRESENT_COPY_PASS + 1, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
             m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->End_Recording(m_command_buffer_identifiers[i]);
         }
     }
@@ -101,6 +605,8 @@ namespace Cascade_Graphics
     {
         LOG_DEBUG << "Vulkan: Recreating swapchain";
 
+        m_previous_camera_data_valid = false;
+
         VALIDATE_VKRESULT(vkDeviceWaitIdle(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device()), "Graphics: Failed to wait for device idle");
 
         for (uint32_t i = 0; i < m_command_buffer_identifiers.size(); i++)
@@ -115,35 +621,36 @@ namespace Cascade_Graphics
         m_swapchain_image_identifiers.clear();
 
         m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(m_render_pipeline_identifier);
+        m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(m_beam_pipeline_identifier);
+        m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(m_reproject_pipeline_identifier);
+        m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(m_upscale_pipeline_identifier);
         m_vulkan_graphics_ptr->m_descriptor_set_manager_ptr->Remove_Descriptor_Set(m_render_compute_descriptor_set_identifier);
+        Destroy_Swapchain_Render_Descriptor_Sets();
 
+        // The object, voxel and BVH buffers don't depend on the swapchain, so they are kept along with their contents instead of being uploaded again
         m_vulkan_graphics_ptr->m_storage_manager_ptr->Destroy_Image(m_render_target_image_identifier);
+        m_vulkan_graphics_ptr->m_storage_manager_ptr->Destroy_Image(m_beam_image_identifier);
+        m_vulkan_graphics_ptr->m_storage_manager_ptr->Destroy_Image(m_output_image_identifier);
         m_vulkan_graphics_ptr->m_storage_manager_ptr->Destroy_Buffer(m_camera_data_identifier);
-        m_vulkan_graphics_ptr->m_storage_manager_ptr->Destroy_Buffer(m_object_buffer_identifier);
-        m_vulkan_graphics_ptr->m_storage_manager_ptr->Destroy_Buffer(m_voxel_buffer_identifier);
         m_vulkan_graphics_ptr->m_storage_manager_ptr->Destroy_Buffer(m_hit_buffer_identifier);
-        m_vulkan_graphics_ptr->m_storage_manager_ptr->Destroy_Buffer(m_staging_buffer_identifier);
+        m_vulkan_graphics_ptr->m_storage_manager_ptr->Destroy_Buffer(m_depth_buffer_identifier);
+        m_vulkan_graphics_ptr->m_storage_manager_ptr->Destroy_Buffer(m_reprojection_buffer_identifier);
         m_vulkan_graphics_ptr->m_storage_manager_ptr->Remove_Resource_Grouping(m_swapchain_resource_grouping_identifier);
         m_vulkan_graphics_ptr->m_storage_manager_ptr->Remove_Resource_Grouping(m_render_compute_resource_grouping_identifier);
 
         m_swapchain_wrapper_ptr.reset();
 
-        m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Destroy_Semaphore(m_image_available_semaphore_identifier);
-        m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Destroy_Semaphore(m_render_finished_semaphore_identifier);
-        m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Destroy_Fence(m_in_flight_fence_identifier);
+        Destroy_Frame_Resources();
 
         uint32_t width = *m_window_information.width_ptr;
         uint32_t height = *m_window_information.height_ptr;
         LOG_DEBUG << "Vulkan: New window size " << width << "x" << height;
 
         m_swapchain_wrapper_ptr = std::make_shared<Vulkan_Backend::Swapchain_Wrapper>(m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr, m_vulkan_graphics_ptr->m_physical_device_wrapper_ptr, m_surface_wrapper_ptr,
-                                                                                      m_vulkan_graphics_ptr->m_queue_manager_ptr, width, height);
+                                                                                      m_vulkan_graphics_ptr->m_queue_manager_ptr, width, height, m_present_policy);
         width = m_swapchain_wrapper_ptr->Get_Swapchain_Extent().width;
         height = m_swapchain_wrapper_ptr->Get_Swapchain_Extent().height;
 
-        std::vector<Object_Manager::GPU_Object> gpu_objects = m_object_manager_ptr->Get_GPU_Objects();
-        std::vector<Object_Manager::GPU_Voxel> gpu_voxels = m_object_manager_ptr->Get_GPU_Voxels();
-
         std::vector<Vulkan_Backend::Storage_Manager::Image_Resource> swapchain_image_resources = m_swapchain_wrapper_ptr->Get_Swapchain_Image_Resources();
         for (uint32_t i = 0; i < swapchain_image_resources.size(); i++)
         {
@@ -153,49 +660,76 @@ namespace Cascade_Graphics
         m_render_target_image_identifier
             = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Image("render_target", swapchain_image_resources.front().image_format, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
                                                                          m_swapchain_wrapper_ptr->Get_Swapchain_Extent(), Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE | Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
-        m_camera_data_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("camera_data", sizeof(Camera::GPU_Camera_Data), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+        m_beam_image_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Image("beam_distances", VK_FORMAT_R32_SFLOAT, VK_IMAGE_USAGE_STORAGE_BIT, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, Get_Beam_Extent(),
+                                                                                            Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE);
+        m_output_image_identifier
+            = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Image("output_image", swapchain_image_resources.front().image_format, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                                                                         m_swapchain_wrapper_ptr->Get_Swapchain_Extent(), Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE | Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
+        m_camera_data_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("camera_data", sizeof(Camera::GPU_Camera_Data), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
                                                                                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                                                                                                Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE | Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
-        m_object_buffer_identifier
-            = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("object_buffer", sizeof(Object_Manager::GPU_Object) * gpu_objects.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                                                          VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE | Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
-        m_voxel_buffer_identifier
-            = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("voxel_buffer", sizeof(Object_Manager::GPU_Voxel) * gpu_voxels.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-                                                                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE | Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
-        m_hit_buffer_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("hit_buffer", sizeof(uint32_t) * 4 * gpu_voxels.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-                                                                                              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE);
-        m_staging_buffer_identifier
-            = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("staging_buffer", 0, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-                                                                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, Vulkan_Backend::Queue_Manager::TRANSFER_QUEUE);
+        m_hit_buffer_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("hit_buffer", sizeof(uint32_t) * 4 * m_hit_buffer_slot_count, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                                                              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE);
+        m_depth_buffer_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("depth_buffer", sizeof(float) * 2 * Get_Pixel_Count(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                                                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE);
+        m_reprojection_buffer_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Buffer("reprojection_buffer", sizeof(uint32_t) * Get_Pixel_Count(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                                                                       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE);
 
         m_swapchain_resource_grouping_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Resource_Grouping("swapchain_resource_grouping", m_swapchain_image_identifiers);
         m_render_compute_resource_grouping_identifier = m_vulkan_graphics_ptr->m_storage_manager_ptr->Create_Resource_Grouping(
-            "render_compute_resource_grouping", {m_render_target_image_identifier, m_camera_data_identifier, m_object_buffer_identifier, m_voxel_buffer_identifier, m_hit_buffer_identifier});
+            "render_compute_resource_grouping", {m_render_target_image_identifier, m_beam_image_identifier, m_output_image_identifier, m_camera_data_identifier, m_object_buffer_identifier, m_voxel_buffer_identifier, m_hit_buffer_identifier, m_bvh_buffer_identifier, m_depth_buffer_identifier, m_reprojection_buffer_identifier});
         m_render_compute_descriptor_set_identifier = m_vulkan_graphics_ptr->m_descriptor_set_manager_ptr->Create_Descriptor_Set(m_render_compute_resource_grouping_identifier);
+        m_direct_swapchain_rendering = m_swapchain_wrapper_ptr->Is_Storage_Usage_Supported();
+        Create_Swapchain_Render_Descriptor_Sets();
 
-        m_render_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("render_pipeline", m_render_compute_descriptor_set_identifier, m_render_shader_identifier);
-        Record_Command_Buffers();
-
-        m_vulkan_graphics_ptr->m_storage_manager_ptr->Upload_To_Buffer_Staging(m_object_buffer_identifier, m_staging_buffer_identifier, gpu_objects.data(), sizeof(Cascade_Graphics::Object_Manager::GPU_Object) * gpu_objects.size(),
-                                                                               m_vulkan_graphics_ptr);
-        m_vulkan_graphics_ptr->m_storage_manager_ptr->Upload_To_Buffer_Staging(m_voxel_buffer_identifier, m_staging_buffer_identifier, gpu_voxels.data(), sizeof(Cascade_Graphics::Object_Manager::GPU_Voxel) * gpu_voxels.size(), m_vulkan_graphics_ptr);
+        m_render_pipeline_identifier = Create_Render_Pipeline(m_render_pipeline_configuration);
+        m_beam_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("beam_pipeline", m_render_compute_descriptor_set_identifier, m_beam_shader_identifier);
+        m_reproject_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("reproject_pipeline", m_render_compute_descriptor_set_identifier, m_reproject_shader_identifier);
+        m_upscale_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("upscale_pipeline", m_render_compute_descriptor_set_identifier, m_upscale_shader_identifier);
 
-        m_image_available_semaphore_identifier = m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Create_Semaphore("image_available_semaphore");
-        m_render_finished_semaphore_identifier = m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Create_Semaphore("render_finished_semaphore");
-        m_in_flight_fence_identifier = m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Create_Fence("in_flight_fence");
+        Create_Frame_Resources();
+        Record_Command_Buffers();
     }
 
     void Renderer::Render_Frame()
     {
+        // The schedule is advanced under the lock, but the wait happens without it so scene updates can run meanwhile. A late frame moves the schedule instead of being caught up
+        bool pace_frame;
+        std::chrono::steady_clock::time_point next_frame_time;
+        {
+            std::unique_lock<std::mutex> pacing_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+
+            pace_frame = m_present_policy == Vulkan_Backend::Swapchain_Wrapper::Present_Policy::TARGET_FRAME_RATE && m_target_frame_rate > 0.0;
+            if (pace_frame)
+            {
+                std::chrono::steady_clock::duration frame_period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / m_target_frame_rate));
+                m_next_frame_time = std::max(m_next_frame_time + frame_period, std::chrono::steady_clock::now());
+                next_frame_time = m_next_frame_time;
+            }
+        }
+
+        if (pace_frame)
+        {
+            std::this_thread::sleep_until(next_frame_time);
+        }
+
         std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
         m_vulkan_graphics_ptr->m_vulkan_object_access_notify.wait(vulkan_object_access_lock, [&] { return m_rendering_active; });
 
-        vkWaitForFences(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device(), 1, m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Fence(m_in_flight_fence_identifier), VK_TRUE, UINT64_MAX);
-        vkResetFences(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device(), 1, m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Fence(m_in_flight_fence_identifier));
+        // Only wait for the frame that last used this slot, the others can still be running on the GPU
+        Frame_Resources& frame_resources = m_frame_resources[m_frame_index];
+        vkWaitForFences(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device(), 1, m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Fence(frame_resources.in_flight_fence_identifier), VK_TRUE, UINT64_MAX);
+
+        Resolve_Frame_Timestamps();
+
+        if (m_traversal_statistics_enabled)
+        {
+            Read_Traversal_Statistics(m_frame_index);
+        }
 
         uint32_t image_index;
         VkResult acquire_next_image_result = vkAcquireNextImageKHR(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device(), *m_swapchain_wrapper_ptr->Get_Swapchain(), UINT64_MAX,
-                                                                   *m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Semaphore(m_image_available_semaphore_identifier), VK_NULL_HANDLE, &image_index);
+                                                                   *m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Semaphore(frame_resources.image_available_semaphore_identifier), VK_NULL_HANDLE, &image_index);
 
         if (acquire_next_image_result == VK_ERROR_OUT_OF_DATE_KHR)
         {
@@ -209,37 +743,99 @@ namespace Cascade_Graphics
             VALIDATE_VKRESULT(acquire_next_image_result, "Vulkan: Failed to acquire next image");
         }
 
-        Cascade_Graphics::Camera::GPU_Camera_Data camera_data = m_camera_ptr->Get_GPU_Camera_Data(which_hit_buffer);
-        m_vulkan_graphics_ptr->m_storage_manager_ptr->Upload_To_Buffer_Direct(m_camera_data_identifier, &camera_data, sizeof(Cascade_Graphics::Camera::GPU_Camera_Data));
-        which_hit_buffer = (which_hit_buffer + 1) % 4;
+        // The fence is only reset once work is sure to be submitted, otherwise the next wait on it would never return
+        vkResetFences(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device(), 1, m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Fence(frame_resources.in_flight_fence_identifier));
 
-        VkPipelineStageFlags pipeline_wait_stage_mask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        Cascade_Graphics::Camera::GPU_Camera_Data camera_data = m_camera_ptr->Get_GPU_Camera_Data(which_hit_buffer);
+        camera_data.beam_prepass_enabled = m_beam_prepass_enabled;
+        camera_data.depth_buffer_index = m_depth_buffer_index;
+        camera_data.reprojection_enabled = m_temporal_reprojection_enabled && m_previous_camera_data_valid;
+        camera_data.previous_matrix_x0 = m_previous_camera_data.matrix_x0;
+        camera_data.previous_matrix_x1 = m_previous_camera_data.matrix_x1;
+        camera_data.previous_matrix_x2 = m_previous_camera_data.matrix_x2;
+        camera_data.previous_matrix_y0 = m_previous_camera_data.matrix_y0;
+        camera_data.previous_matrix_y1 = m_previous_camera_data.matrix_y1;
+        camera_data.previous_matrix_y2 = m_previous_camera_data.matrix_y2;
+        camera_data.previous_matrix_z0 = m_previous_camera_data.matrix_z0;
+        camera_data.previous_matrix_z1 = m_previous_camera_data.matrix_z1;
+        camera_data.previous_matrix_z2 = m_previous_camera_data.matrix_z2;
+        camera_data.previous_origin_x = m_previous_camera_data.origin_x;
+        camera_data.previous_origin_y = m_previous_camera_data.origin_y;
+        camera_data.previous_origin_z = m_previous_camera_data.origin_z;
+        VkExtent2D render_extent = Get_Render_Extent();
+        camera_data.render_width = render_extent.width;
+        camera_data.render_height = render_extent.height;
+        camera_data.previous_render_width = m_previous_camera_data.render_width;
+        camera_data.previous_render_height = m_previous_camera_data.render_height;
+        camera_data.debug_view = m_debug_view;
+        camera_data.statistics_enabled = m_traversal_statistics_enabled;
+        m_vulkan_graphics_ptr->m_storage_manager_ptr->Upload_To_Buffer_Direct(m_camera_upload_buffer_identifier, &camera_data, sizeof(Cascade_Graphics::Camera::GPU_Camera_Data),
+                                                                              sizeof(Cascade_Graphics::Camera::GPU_Camera_Data) * m_frame_index);
+
+        // This frame's depth becomes next frame's history
+        m_previous_camera_data = camera_data;
+        m_previous_camera_data_valid = true;
+        m_depth_buffer_index = 1 - m_depth_buffer_index;
+
+        frame_resources.traversal_statistics_pending = m_traversal_statistics_enabled;
+        frame_resources.traversal_statistics_slot = which_hit_buffer;
+        frame_resources.traversal_ray_count = static_cast<uint64_t>(render_extent.width) * render_extent.height;
+        which_hit_buffer = (which_hit_buffer + 1) % m_hit_buffer_slot_count;
+
+        uint32_t command_buffer_index = m_frame_index * m_swapchain_wrapper_ptr->Get_Swapchain_Image_Count() + image_index;
+
+        // Waiting on the latest upload happens on the GPU, so streaming content never blocks this thread
+        VkSemaphore wait_semaphores[2] = {*m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Semaphore(frame_resources.image_available_semaphore_identifier), *m_vulkan_graphics_ptr->m_transfer_manager_ptr->Get_Timeline_Semaphore()};
+        uint64_t wait_values[2] = {0, m_transfer_ticket};
+        VkPipelineStageFlags pipeline_wait_stage_masks[2] = {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT};
+
+        m_render_timeline_value++;
+        VkSemaphore signal_semaphores[2] = {*m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Semaphore(m_render_finished_semaphore_identifiers[image_index]),
+                                            *m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Semaphore(m_render_timeline_semaphore_identifier)};
+        uint64_t signal_values[2] = {0, m_render_timeline_value};
+
+        VkTimelineSemaphoreSubmitInfo timeline_semaphore_submit_info = {};
+        timeline_semaphore_submit_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timeline_semaphore_submit_info.pNext = nullptr;
+        timeline_semaphore_submit_info.waitSemaphoreValueCount = 2;
+        timeline_semaphore_submit_info.pWaitSemaphoreValues = wait_values;
+        timeline_semaphore_submit_info.signalSemaphoreValueCount = 2;
+        timeline_semaphore_submit_info.pSignalSemaphoreValues = signal_values;
 
         VkSubmitInfo submit_info = {};
         submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submit_info.pNext = nullptr;
-        submit_info.waitSemaphoreCount = 1;
-        submit_info.pWaitSemaphores = m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Semaphore(m_image_available_semaphore_identifier);
-        submit_info.pWaitDstStageMask = &pipeline_wait_stage_mask;
+        submit_info.pNext = &timeline_semaphore_submit_info;
+        submit_info.waitSemaphoreCount = 2;
+        submit_info.pWaitSemaphores = wait_semaphores;
+        submit_info.pWaitDstStageMask = pipeline_wait_stage_masks;
         submit_info.commandBufferCount = 1;
-        submit_info.pCommandBuffers = m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Get_Command_Buffer(m_command_buffer_identifiers[image_index]);
-        submit_info.signalSemaphoreCount = 1;
-        submit_info.pSignalSemaphores = m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Semaphore(m_image_available_semaphore_identifier);
+        submit_info.pCommandBuffers = m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Get_Command_Buffer(m_command_buffer_identifiers[command_buffer_index]);
+        submit_info.signalSemaphoreCount = 2;
+        submit_info.pSignalSemaphores = signal_semaphores;
 
         VALIDATE_VKRESULT(vkQueueSubmit(*m_vulkan_graphics_ptr->m_queue_manager_ptr->Get_Queue(Vulkan_Backend::Queue_Manager::Queue_Types::COMPUTE_QUEUE), 1, &submit_info,
-                                        *m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Fence(m_in_flight_fence_identifier)),
+                                        *m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Fence(frame_resources.in_flight_fence_identifier)),
                           "Vulkan: Failed to submit queue");
+        if (m_frame_timestamps_supported)
+        {
+            // Submitting a command buffer resets its queries, so an older unresolved result for it is gone
+            m_pending_frame_timestamp_command_buffer_indices.erase(std::remove(m_pending_frame_timestamp_command_buffer_indices.begin(), m_pending_frame_timestamp_command_buffer_indices.end(), command_buffer_index),
+                                                                   m_pending_frame_timestamp_command_buffer_indices.end());
+            m_pending_frame_timestamp_command_buffer_indices.push_back(command_buffer_index);
+        }
 
         VkPresentInfoKHR present_info = {};
         present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
         present_info.pNext = nullptr;
         present_info.waitSemaphoreCount = 1;
-        present_info.pWaitSemaphores = m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Semaphore(m_image_available_semaphore_identifier);
+        present_info.pWaitSemaphores = m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Semaphore(m_render_finished_semaphore_identifiers[image_index]);
         present_info.swapchainCount = 1;
         present_info.pSwapchains = m_swapchain_wrapper_ptr->Get_Swapchain();
         present_info.pImageIndices = &image_index;
         present_info.pResults = nullptr;
 
+        m_frame_index = (m_frame_index + 1) % m_frames_in_flight;
+
         VkResult queue_present_result = vkQueuePresentKHR(*m_vulkan_graphics_ptr->m_queue_manager_ptr->Get_Queue(Vulkan_Backend::Queue_Manager::Queue_Types::PRESENT_QUEUE), &present_info);
 
         if (queue_present_result == VK_ERROR_OUT_OF_DATE_KHR || queue_present_result == VK_SUBOPTIMAL_KHR)
@@ -263,18 +859,81 @@ namespace Cascade_Graphics
 
     void Renderer::Update_Objects()
     {
-        std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
-        m_vulkan_graphics_ptr->m_vulkan_object_access_notify.wait(vulkan_object_access_lock, [&] { return m_renderer_initialized; });
+        size_t object_count = m_object_manager_ptr->Get_Object_Count();
+        const std::vector<Object_Manager::GPU_BVH_Node>& gpu_bvh_nodes = m_object_manager_ptr->Get_GPU_BVH_Nodes();
 
-        VALIDATE_VKRESULT(vkDeviceWaitIdle(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device()), "Graphics: Failed to wait for device idle");
+        VkSemaphore render_timeline_semaphore;
+        {
+            std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+            m_vulkan_graphics_ptr->m_vulkan_object_access_notify.wait(vulkan_object_access_lock, [&] { return m_renderer_initialized; });
 
-        std::vector<Object_Manager::GPU_Object> gpu_objects = m_object_manager_ptr->Get_GPU_Objects();
+            bool object_buffer_too_small = m_vulkan_graphics_ptr->m_storage_manager_ptr->Get_Buffer_Resource(m_object_buffer_identifier)->buffer_size < sizeof(Object_Manager::GPU_Object) * object_count;
+            bool bvh_buffer_too_small = m_vulkan_graphics_ptr->m_storage_manager_ptr->Get_Buffer_Resource(m_bvh_buffer_identifier)->buffer_size < sizeof(Object_Manager::GPU_BVH_Node) * gpu_bvh_nodes.size();
 
-        if (m_vulkan_graphics_ptr->m_storage_manager_ptr->Get_Buffer_Resource(m_object_buffer_identifier)->buffer_size < sizeof(Object_Manager::GPU_Object) * gpu_objects.size())
+            render_timeline_semaphore = *m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Semaphore(m_render_timeline_semaphore_identifier);
+
+            if (object_buffer_too_small || bvh_buffer_too_small)
+            {
+                LOG_DEBUG << "Graphics: Increasing object buffer size";
+
+                VALIDATE_VKRESULT(vkDeviceWaitIdle(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device()), "Graphics: Failed to wait for device idle");
+
+                // The old contents are copied over, so frames rendered before the new contents arrive still see a consistent scene
+                if (object_buffer_too_small)
+                {
+                    m_transfer_ticket = m_vulkan_graphics_ptr->m_transfer_manager_ptr->Grow_Buffer(m_object_buffer_identifier, sizeof(Cascade_Graphics::Object_Manager::GPU_Object) * object_count, render_timeline_semaphore,
+                                                                                                   m_render_timeline_value);
+                }
+                if (bvh_buffer_too_small)
+                {
+                    m_transfer_ticket = m_vulkan_graphics_ptr->m_transfer_manager_ptr->Grow_Buffer(m_bvh_buffer_identifier, sizeof(Cascade_Graphics::Object_Manager::GPU_BVH_Node) * gpu_bvh_nodes.size(), render_timeline_semaphore,
+                                                                                                   m_render_timeline_value);
+                }
+
+                for (uint32_t i = 0; i < m_command_buffer_identifiers.size(); i++)
+                {
+                    m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Remove_Command_Buffer(m_command_buffer_identifiers[i]);
+                }
+                m_command_buffer_identifiers.clear();
+                m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(m_render_pipeline_identifier);
+                m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(m_beam_pipeline_identifier);
+                m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(m_reproject_pipeline_identifier);
+                m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(m_upscale_pipeline_identifier);
+                m_vulkan_graphics_ptr->m_descriptor_set_manager_ptr->Remove_Descriptor_Set(m_render_compute_descriptor_set_identifier);
+                Destroy_Swapchain_Render_Descriptor_Sets();
+
+                m_render_compute_descriptor_set_identifier = m_vulkan_graphics_ptr->m_descriptor_set_manager_ptr->Create_Descriptor_Set(m_render_compute_resource_grouping_identifier);
+                Create_Swapchain_Render_Descriptor_Sets();
+                m_render_pipeline_identifier = Create_Render_Pipeline(m_render_pipeline_configuration);
+                m_beam_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("beam_pipeline", m_render_compute_descriptor_set_identifier, m_beam_shader_identifier);
+                m_reproject_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("reproject_pipeline", m_render_compute_descriptor_set_identifier, m_reproject_shader_identifier);
+                m_upscale_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("upscale_pipeline", m_render_compute_descriptor_set_identifier, m_upscale_shader_identifier);
+                Record_Command_Buffers();
+            }
+        }
+
+        // Staging can wait for room in the ring, so it happens without the lock and frames keep being rendered meanwhile. The object manager must not change until it returns.
+        // Each chunk waits for the frames submitted before it and publishes its ticket as it is submitted, so frames rendered during the upload never race a copy
+        m_vulkan_graphics_ptr->m_transfer_manager_ptr->Upload_To_Buffer(
+            m_object_buffer_identifier, sizeof(Cascade_Graphics::Object_Manager::GPU_Object), 0, object_count,
+            [this](void* mapped_memory, size_t first_object_index, size_t upload_object_count) { m_object_manager_ptr->Write_GPU_Objects(static_cast<Object_Manager::GPU_Object*>(mapped_memory), first_object_index, upload_object_count); },
+            Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE, render_timeline_semaphore, &m_render_timeline_value, &m_transfer_ticket);
+        m_vulkan_graphics_ptr->m_transfer_manager_ptr->Upload_To_Buffer(m_bvh_buffer_identifier, gpu_bvh_nodes.data(), sizeof(Cascade_Graphics::Object_Manager::GPU_BVH_Node) * gpu_bvh_nodes.size(),
+                                                                        Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE, render_timeline_semaphore, &m_render_timeline_value, &m_transfer_ticket);
+    }
+
+    void Renderer::Grow_Voxel_Buffer(size_t voxel_count, VkSemaphore render_timeline_semaphore)
+    {
+        // Called with the Vulkan objects mutex held
+        if (m_vulkan_graphics_ptr->m_storage_manager_ptr->Get_Buffer_Resource(m_voxel_buffer_identifier)->buffer_size < sizeof(Object_Manager::GPU_Voxel) * voxel_count)
         {
-            LOG_DEBUG << "Graphics: Increasing object buffer size";
+            LOG_DEBUG << "Graphics: Increasing voxel buffer size";
 
-            m_vulkan_graphics_ptr->m_storage_manager_ptr->Resize_Buffer(m_object_buffer_identifier, sizeof(Cascade_Graphics::Object_Manager::GPU_Object) * gpu_objects.size());
+            VALIDATE_VKRESULT(vkDeviceWaitIdle(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device()), "Graphics: Failed to wait for device idle");
+
+            // The voxels already on the GPU are copied over, so only the appended ones have to be uploaded
+            m_transfer_ticket = m_vulkan_graphics_ptr->m_transfer_manager_ptr->Grow_Buffer(m_voxel_buffer_identifier, sizeof(Cascade_Graphics::Object_Manager::GPU_Voxel) * voxel_count, render_timeline_semaphore,
+                                                                                           m_render_timeline_value);
 
             for (uint32_t i = 0; i < m_command_buffer_identifiers.size(); i++)
             {
@@ -282,49 +941,321 @@ namespace Cascade_Graphics
             }
             m_command_buffer_identifiers.clear();
             m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(m_render_pipeline_identifier);
+            m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(m_beam_pipeline_identifier);
+            m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(m_reproject_pipeline_identifier);
+            m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(m_upscale_pipeline_identifier);
             m_vulkan_graphics_ptr->m_descriptor_set_manager_ptr->Remove_Descriptor_Set(m_render_compute_descriptor_set_identifier);
+            Destroy_Swapchain_Render_Descriptor_Sets();
 
             m_render_compute_descriptor_set_identifier = m_vulkan_graphics_ptr->m_descriptor_set_manager_ptr->Create_Descriptor_Set(m_render_compute_resource_grouping_identifier);
-            m_render_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("render_pipeline", m_render_compute_descriptor_set_identifier, m_render_shader_identifier);
+            Create_Swapchain_Render_Descriptor_Sets();
+            m_render_pipeline_identifier = Create_Render_Pipeline(m_render_pipeline_configuration);
+            m_beam_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("beam_pipeline", m_render_compute_descriptor_set_identifier, m_beam_shader_identifier);
+            m_reproject_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("reproject_pipeline", m_render_compute_descriptor_set_identifier, m_reproject_shader_identifier);
+            m_upscale_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("upscale_pipeline", m_render_compute_descriptor_set_identifier, m_upscale_shader_identifier);
             Record_Command_Buffers();
         }
-
-        m_vulkan_graphics_ptr->m_storage_manager_ptr->Upload_To_Buffer_Staging(m_object_buffer_identifier, m_staging_buffer_identifier, gpu_objects.data(), sizeof(Cascade_Graphics::Object_Manager::GPU_Object) * gpu_objects.size(),
-                                                                               m_vulkan_graphics_ptr);
     }
 
     void Renderer::Update_Voxels()
     {
+        size_t gpu_voxel_count = m_object_manager_ptr->Get_GPU_Voxel_Count();
+
+        VkSemaphore render_timeline_semaphore;
+        size_t uploaded_voxel_count;
+        {
+            std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+            m_vulkan_graphics_ptr->m_vulkan_object_access_notify.wait(vulkan_object_access_lock, [&] { return m_renderer_initialized; });
+
+            render_timeline_semaphore = *m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Semaphore(m_render_timeline_semaphore_identifier);
+
+            // Voxels copied in by the GPU octree builder can be ahead of the object manager until their object is registered
+            gpu_voxel_count = std::max(gpu_voxel_count, m_uploaded_voxel_count);
+
+            Grow_Voxel_Buffer(gpu_voxel_count, render_timeline_semaphore);
+
+            // Voxels are only ever appended, so everything before the last uploaded voxel is already in the buffer
+            uploaded_voxel_count = m_uploaded_voxel_count;
+            m_uploaded_voxel_count = gpu_voxel_count;
+        }
+
+        // The render timeline value and transfer ticket are read and published under the lock with each chunk's submission
+        m_vulkan_graphics_ptr->m_transfer_manager_ptr->Upload_To_Buffer(
+            m_voxel_buffer_identifier, sizeof(Cascade_Graphics::Object_Manager::GPU_Voxel), uploaded_voxel_count, gpu_voxel_count - uploaded_voxel_count,
+            [this](void* mapped_memory, size_t first_voxel_index, size_t upload_voxel_count) { m_object_manager_ptr->Write_GPU_Voxels(static_cast<Object_Manager::GPU_Voxel*>(mapped_memory), first_voxel_index, upload_voxel_count); },
+            Vulkan_Backend::Queue_Manager::COMPUTE_QUEUE, render_timeline_semaphore, &m_render_timeline_value, &m_transfer_ticket);
+
+        // Transfers complete in submission order, so uploading the objects last means no frame sees an object before its voxels
         Update_Objects();
 
+        m_object_manager_ptr->Apply_Voxel_Retention_Policies();
+    }
+
+    uint64_t Renderer::Copy_Voxels_From_Buffer(Vulkan_Backend::Identifier source_buffer_identifier, size_t first_voxel_index, size_t voxel_count)
+    {
+        // Voxels still held on the host are uploaded first, the copied ones are placed right after them
+        Update_Voxels();
+
+        std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+
+        if (m_uploaded_voxel_count != first_voxel_index)
+        {
+            LOG_ERROR << "Graphics: Voxels copied to voxel " << first_voxel_index << " have to follow the " << m_uploaded_voxel_count << " voxels already in the voxel buffer";
+            exit(EXIT_FAILURE);
+        }
+
+        Grow_Voxel_Buffer(first_voxel_index + voxel_count, *m_vulkan_graphics_ptr->m_synchronization_manager_ptr->Get_Semaphore(m_render_timeline_semaphore_identifier));
+
+        // No object references these voxels until the next object upload, which is ordered after this copy, so frames in flight don't have to be waited for
+        uint64_t transfer_ticket = m_vulkan_graphics_ptr->m_transfer_manager_ptr->Copy_Buffer(source_buffer_identifier, m_voxel_buffer_identifier, 0, sizeof(Object_Manager::GPU_Voxel) * first_voxel_index, sizeof(Object_Manager::GPU_Voxel) * voxel_count);
+
+        m_transfer_ticket = std::max(m_transfer_ticket, transfer_ticket);
+        m_uploaded_voxel_count = first_voxel_index + voxel_count;
+
+        return transfer_ticket;
+    }
+
+    void Renderer::Set_Beam_Prepass_Enabled(bool beam_prepass_enabled)
+    {
         std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
         m_vulkan_graphics_ptr->m_vulkan_object_access_notify.wait(vulkan_object_access_lock, [&] { return m_renderer_initialized; });
 
         VALIDATE_VKRESULT(vkDeviceWaitIdle(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device()), "Graphics: Failed to wait for device idle");
 
-        std::vector<Object_Manager::GPU_Voxel> gpu_voxels = m_object_manager_ptr->Get_GPU_Voxels();
+        m_beam_prepass_enabled = beam_prepass_enabled;
 
-        if (m_vulkan_graphics_ptr->m_storage_manager_ptr->Get_Buffer_Resource(m_voxel_buffer_identifier)->buffer_size < sizeof(Object_Manager::GPU_Voxel) * gpu_voxels.size())
+        for (uint32_t i = 0; i < m_command_buffer_identifiers.size(); i++)
         {
-            LOG_DEBUG << "Graphics: Increasing voxel buffer size";
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Remove_Command_Buffer(m_command_buffer_identifiers[i]);
+        }
+        m_command_buffer_identifiers.clear();
+        Record_Command_Buffers();
+    }
 
-            m_vulkan_graphics_ptr->m_storage_manager_ptr->Resize_Buffer(m_voxel_buffer_identifier, sizeof(Cascade_Graphics::Object_Manager::GPU_Voxel) * gpu_voxels.size());
-            m_vulkan_graphics_ptr->m_storage_manager_ptr->Resize_Buffer(m_hit_buffer_identifier, sizeof(uint32_t) * 4 * gpu_voxels.size());
+    void Renderer::Set_Temporal_Reprojection_Enabled(bool temporal_reprojection_enabled)
+    {
+        std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+        m_vulkan_graphics_ptr->m_vulkan_object_access_notify.wait(vulkan_object_access_lock, [&] { return m_renderer_initialized; });
 
-            for (uint32_t i = 0; i < m_command_buffer_identifiers.size(); i++)
+        VALIDATE_VKRESULT(vkDeviceWaitIdle(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device()), "Graphics: Failed to wait for device idle");
+
+        m_temporal_reprojection_enabled = temporal_reprojection_enabled;
+
+        for (uint32_t i = 0; i < m_command_buffer_identifiers.size(); i++)
+        {
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Remove_Command_Buffer(m_command_buffer_identifiers[i]);
+        }
+        m_command_buffer_identifiers.clear();
+        Record_Command_Buffers();
+    }
+
+    void Renderer::Set_Dynamic_Resolution_Enabled(bool dynamic_resolution_enabled)
+    {
+        std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+        m_vulkan_graphics_ptr->m_vulkan_object_access_notify.wait(vulkan_object_access_lock, [&] { return m_renderer_initialized; });
+
+        VALIDATE_VKRESULT(vkDeviceWaitIdle(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device()), "Graphics: Failed to wait for device idle");
+
+        m_dynamic_resolution_enabled = dynamic_resolution_enabled;
+        if (!m_dynamic_resolution_enabled)
+        {
+            m_render_scale = 1.0;
+        }
+
+        for (uint32_t i = 0; i < m_command_buffer_identifiers.size(); i++)
+        {
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Remove_Command_Buffer(m_command_buffer_identifiers[i]);
+        }
+        m_command_buffer_identifiers.clear();
+
+        // Which pass writes the swapchain image depends on whether there is an upscale
+        Destroy_Swapchain_Render_Descriptor_Sets();
+        Create_Swapchain_Render_Descriptor_Sets();
+        Record_Command_Buffers();
+    }
+
+    void Renderer::Set_Target_Frame_Time(double target_frame_time)
+    {
+        // The target feeds the render scale, which ends up cast to the render extent
+        if (!std::isfinite(target_frame_time) || target_frame_time <= 0.0)
+        {
+            LOG_WARN << "Graphics: Ignoring target frame time of " << target_frame_time << " ms, it must be a positive number";
+            return;
+        }
+
+        std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+
+        m_target_frame_time = target_frame_time;
+    }
+
+    void Renderer::Set_Frames_In_Flight(uint32_t frames_in_flight)
+    {
+        std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+        m_vulkan_graphics_ptr->m_vulkan_object_access_notify.wait(vulkan_object_access_lock, [&] { return m_renderer_initialized; });
+
+        VALIDATE_VKRESULT(vkDeviceWaitIdle(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device()), "Graphics: Failed to wait for device idle");
+
+        // Every frame in flight needs its own statistics slot in the hit buffer
+        if (frames_in_flight < 1 || frames_in_flight > m_hit_buffer_slot_count)
+        {
+            LOG_WARN << "Graphics: Clamping " << frames_in_flight << " frames in flight to the range 1 to " << m_hit_buffer_slot_count;
+            frames_in_flight = std::clamp(frames_in_flight, 1u, m_hit_buffer_slot_count);
+        }
+
+        for (uint32_t i = 0; i < m_command_buffer_identifiers.size(); i++)
+        {
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Remove_Command_Buffer(m_command_buffer_identifiers[i]);
+        }
+        m_command_buffer_identifiers.clear();
+        Destroy_Frame_Resources();
+
+        m_frames_in_flight = frames_in_flight;
+
+        Create_Frame_Resources();
+        Record_Command_Buffers();
+    }
+
+    void Renderer::Set_Present_Policy(Vulkan_Backend::Swapchain_Wrapper::Present_Policy present_policy, double target_frame_rate)
+    {
+        std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+        m_vulkan_graphics_ptr->m_vulkan_object_access_notify.wait(vulkan_object_access_lock, [&] { return m_renderer_initialized; });
+
+        m_present_policy = Get_Supported_Present_Policy(present_policy, target_frame_rate);
+        m_target_frame_rate = target_frame_rate;
+
+        // The present mode and image count are fixed when the swapchain is created
+        Recreate_Swapchain();
+    }
+
+    double Renderer::Get_Render_Scale()
+    {
+        std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+
+        return m_render_scale;
+    }
+
+    std::vector<Renderer::Frame_Pass_Timing> Renderer::Get_Frame_Pass_Timings()
+    {
+        std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+
+        const std::string frame_pass_names[FRAME_PASS_COUNT + 1] = {"layout_transitions", "reprojection", "beam_prepass", "render", "upscale", "present_copy", "frame"};
+
+        std::vector<Frame_Pass_Timing> frame_pass_timings(m_frame_pass_time_samples.size());
+        for (uint32_t i = 0; i < m_frame_pass_time_samples.size(); i++)
+        {
+            frame_pass_timings[i] = {};
+            frame_pass_timings[i].name = frame_pass_names[i];
+            frame_pass_timings[i].sample_count = m_frame_pass_time_samples[i].size();
+
+            if (m_frame_pass_time_samples[i].empty())
             {
-                m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Remove_Command_Buffer(m_command_buffer_identifiers[i]);
+                continue;
             }
-            m_command_buffer_identifiers.clear();
-            m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(m_render_pipeline_identifier);
-            m_vulkan_graphics_ptr->m_descriptor_set_manager_ptr->Remove_Descriptor_Set(m_render_compute_descriptor_set_identifier);
 
-            m_render_compute_descriptor_set_identifier = m_vulkan_graphics_ptr->m_descriptor_set_manager_ptr->Create_Descriptor_Set(m_render_compute_resource_grouping_identifier);
-            m_render_pipeline_identifier = m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Add_Compute_Pipeline("render_pipeline", m_render_compute_descriptor_set_identifier, m_render_shader_identifier);
-            Record_Command_Buffers();
+            std::vector<double> sorted_samples(m_frame_pass_time_samples[i].begin(), m_frame_pass_time_samples[i].end());
+            std::sort(sorted_samples.begin(), sorted_samples.end());
+
+            double total_time = 0.0;
+            for (uint32_t j = 0; j < sorted_samples.size(); j++)
+            {
+                total_time += sorted_samples[j];
+            }
+
+            frame_pass_timings[i].mean_time = total_time / sorted_samples.size();
+            frame_pass_timings[i].p95_time = sorted_samples[static_cast<size_t>(std::ceil(0.95 * sorted_samples.size())) - 1];
+            frame_pass_timings[i].max_time = sorted_samples.back();
+        }
+
+        return frame_pass_timings;
+    }
+
+    void Renderer::Tune_Render_Pipeline()
+    {
+        std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+        m_vulkan_graphics_ptr->m_vulkan_object_access_notify.wait(vulkan_object_access_lock, [&] { return m_renderer_initialized; });
+
+        if (!m_frame_timestamps_supported)
+        {
+            LOG_WARN << "Graphics: Cannot tune render pipeline without GPU timestamp support";
+            return;
+        }
+
+        VALIDATE_VKRESULT(vkDeviceWaitIdle(*m_vulkan_graphics_ptr->m_logical_device_wrapper_ptr->Get_Device()), "Graphics: Failed to wait for device idle");
+
+        LOG_INFO << "Graphics: Tuning render pipeline";
+
+        // Time the current view at full resolution, without the pre-passes so only primary ray traversal is measured
+        Cascade_Graphics::Camera::GPU_Camera_Data camera_data = m_camera_ptr->Get_GPU_Camera_Data(which_hit_buffer);
+        camera_data.beam_prepass_enabled = 0;
+        camera_data.reprojection_enabled = 0;
+        camera_data.depth_buffer_index = m_depth_buffer_index;
+        camera_data.render_width = m_swapchain_wrapper_ptr->Get_Swapchain_Extent().width;
+        camera_data.render_height = m_swapchain_wrapper_ptr->Get_Swapchain_Extent().height;
+        m_vulkan_graphics_ptr->m_storage_manager_ptr->Upload_To_Buffer_Direct(m_camera_data_identifier, &camera_data, sizeof(Cascade_Graphics::Camera::GPU_Camera_Data));
+
+        const std::vector<std::pair<uint32_t, uint32_t>> candidate_workgroup_sizes = {{8, 8}, {16, 8}, {8, 16}, {16, 16}, {32, 8}, {32, 16}, {32, 32}, {64, 4}};
+
+        Render_Pipeline_Configuration best_configuration = m_render_pipeline_configuration;
+        double best_dispatch_time = std::numeric_limits<double>::infinity();
+        for (uint32_t i = 0; i < candidate_workgroup_sizes.size(); i++)
+        {
+            Render_Pipeline_Configuration configuration = m_render_pipeline_configuration;
+            configuration.workgroup_width = candidate_workgroup_sizes[i].first;
+            configuration.workgroup_height = candidate_workgroup_sizes[i].second;
+
+            if (!Render_Pipeline_Configuration_Supported(configuration))
+            {
+                continue;
+            }
+
+            double dispatch_time = Time_Render_Pipeline(configuration);
+            LOG_DEBUG << "Graphics: Render workgroup size " << configuration.workgroup_width << "x" << configuration.workgroup_height << " took " << dispatch_time << " ms";
+
+            if (dispatch_time < best_dispatch_time)
+            {
+                best_configuration = configuration;
+                best_dispatch_time = dispatch_time;
+            }
+        }
+
+        LOG_INFO << "Graphics: Selected render workgroup size " << best_configuration.workgroup_width << "x" << best_configuration.workgroup_height;
+
+        m_render_pipeline_configuration = best_configuration;
+        Save_Render_Pipeline_Configuration();
+
+        // The tuning dispatches overwrote this frame's depth
+        m_previous_camera_data_valid = false;
+
+        for (uint32_t i = 0; i < m_command_buffer_identifiers.size(); i++)
+        {
+            m_vulkan_graphics_ptr->m_command_buffer_manager_ptr->Remove_Command_Buffer(m_command_buffer_identifiers[i]);
         }
+        m_command_buffer_identifiers.clear();
+        m_vulkan_graphics_ptr->m_pipeline_manager_ptr->Delete_Pipeline(m_render_pipeline_identifier);
+
+        m_render_pipeline_identifier = Create_Render_Pipeline(m_render_pipeline_configuration);
+        Record_Command_Buffers();
+    }
+
+    void Renderer::Set_Debug_View(Debug_View debug_view)
+    {
+        std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+
+        m_debug_view = debug_view;
+    }
+
+    void Renderer::Set_Traversal_Statistics_Enabled(bool traversal_statistics_enabled)
+    {
+        std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
+
+        m_traversal_statistics_enabled = traversal_statistics_enabled;
+    }
+
+    Renderer::Traversal_Statistics Renderer::Get_Traversal_Statistics()
+    {
+        std::unique_lock<std::mutex> vulkan_object_access_lock(m_vulkan_graphics_ptr->m_vulkan_objects_access_mutex);
 
-        m_vulkan_graphics_ptr->m_storage_manager_ptr->Upload_To_Buffer_Staging(m_voxel_buffer_identifier, m_staging_buffer_identifier, gpu_voxels.data(), sizeof(Cascade_Graphics::Object_Manager::GPU_Voxel) * gpu_voxels.size(), m_vulkan_graphics_ptr);
+        return m_traversal_statistics;
     }
 
     void Renderer::Start_Rendering()
@@ -5,10 +5,19 @@
 #include "Vulkan_Wrapper/swapchain_wrapper.hpp"
 #include "Vulkan_Wrapper/vulkan_graphics.hpp"
 #include "camera.hpp"
+#include "gpu_octree_builder.hpp"
 #include "object_manager.hpp"
 #include "window_information.hpp"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <limits>
 #include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <vector>
 
 
@@ -16,58 +25,197 @@ namespace Cascade_Graphics
 {
     class Renderer
     {
+    public:
+        enum Debug_View
+        {
+            SHADED,
+            TRAVERSAL_HEATMAP
+        };
+
+        enum Frame_Pass
+        {
+            LAYOUT_TRANSITION_PASS,
+            REPROJECTION_PASS,
+            BEAM_PREPASS,
+            RENDER_PASS,
+            UPSCALE_PASS,
+            PRESENT_COPY_PASS,
+            FRAME_PASS_COUNT
+        };
+
+        struct Frame_Pass_Timing
+        {
+            std::string name;
+            uint32_t sample_count;
+            double mean_time;
+            double p95_time;
+            double max_time;
+        };
+
+        struct Traversal_Statistics
+        {
+            uint64_t traversal_step_count;
+            uint64_t leaf_test_count;
+            uint64_t hit_count;
+            uint64_t ray_count;
+        };
+
+        struct Render_Pipeline_Configuration
+        {
+            uint32_t workgroup_width;
+            uint32_t workgroup_height;
+            uint32_t max_iterations;
+        };
+
+    private:
+        struct Frame_Resources
+        {
+            Vulkan_Backend::Identifier image_available_semaphore_identifier;
+            Vulkan_Backend::Identifier in_flight_fence_identifier;
+
+            bool traversal_statistics_pending;
+            uint32_t traversal_statistics_slot;
+            uint64_t traversal_ray_count;
+        };
+
     private:
 #ifdef CSD_LOG_FPS
         std::chrono::time_point<std::chrono::high_resolution_clock> m_previous_present;
 #endif
 
         uint32_t which_hit_buffer = 0;
+        uint32_t m_hit_buffer_slot_count = 4;
+        uint32_t m_depth_buffer_index = 0;
+        uint32_t m_frames_in_flight = 2;
+        uint32_t m_frame_index = 0;
+
+        Camera::GPU_Camera_Data m_previous_camera_data = {};
+        bool m_previous_camera_data_valid = false;
 
         bool m_renderer_initialized = false;
         bool m_rendering_active = false;
+        bool m_beam_prepass_enabled = true;
+        bool m_temporal_reprojection_enabled = true;
+        bool m_dynamic_resolution_enabled = true;
+        bool m_direct_swapchain_rendering = false;
+
+        bool m_frame_timestamps_supported = false;
+        std::vector<uint32_t> m_pending_frame_timestamp_command_buffer_indices;
+        std::vector<std::deque<double>> m_frame_pass_time_samples = std::vector<std::deque<double>>(FRAME_PASS_COUNT + 1);
+        uint32_t m_frame_pass_time_window = 256;
+
+        Vulkan_Backend::Swapchain_Wrapper::Present_Policy m_present_policy;
+        double m_target_frame_rate;
+        std::chrono::steady_clock::time_point m_next_frame_time;
+
+        double m_render_scale = 1.0;
+        double m_minimum_render_scale = 0.5;
+        double m_target_frame_time = 1000.0 / 60.0;
+
+        Debug_View m_debug_view = Debug_View::SHADED;
+        bool m_traversal_statistics_enabled = false;
+        Traversal_Statistics m_traversal_statistics = {};
+
+        Render_Pipeline_Configuration m_render_pipeline_configuration = {32, 32, 1000000};
+        std::string m_render_pipeline_tuning_path = "render_pipeline_tuning.txt";
 
-        Vulkan_Backend::Identifier m_image_available_semaphore_identifier;
-        Vulkan_Backend::Identifier m_render_finished_semaphore_identifier;
-        Vulkan_Backend::Identifier m_in_flight_fence_identifier;
+        std::vector<Frame_Resources> m_frame_resources;
+        std::vector<Vulkan_Backend::Identifier> m_render_finished_semaphore_identifiers;
+        Vulkan_Backend::Identifier m_render_timeline_semaphore_identifier;
+        // Guarded by the Vulkan objects mutex, uploads read and advance them as each chunk is submitted
+        uint64_t m_render_timeline_value = 0;
+        uint64_t m_transfer_ticket = 0;
+        size_t m_uploaded_voxel_count = 0;
+        Vulkan_Backend::Identifier m_frame_timestamp_query_pool_identifier;
 
         std::shared_ptr<Vulkan_Backend::Surface_Wrapper> m_surface_wrapper_ptr;
         std::shared_ptr<Vulkan_Backend::Swapchain_Wrapper> m_swapchain_wrapper_ptr;
 
         Vulkan_Backend::Identifier m_render_shader_identifier;
         Vulkan_Backend::Identifier m_render_pipeline_identifier;
+        Vulkan_Backend::Identifier m_beam_shader_identifier;
+        Vulkan_Backend::Identifier m_beam_pipeline_identifier;
+        Vulkan_Backend::Identifier m_reproject_shader_identifier;
+        Vulkan_Backend::Identifier m_reproject_pipeline_identifier;
+        Vulkan_Backend::Identifier m_upscale_shader_identifier;
+        Vulkan_Backend::Identifier m_upscale_pipeline_identifier;
         std::vector<Vulkan_Backend::Identifier> m_command_buffer_identifiers;
 
         Vulkan_Backend::Identifier m_swapchain_resource_grouping_identifier;
         Vulkan_Backend::Identifier m_render_compute_resource_grouping_identifier;
         Vulkan_Backend::Identifier m_render_compute_descriptor_set_identifier;
+        std::vector<Vulkan_Backend::Identifier> m_swapchain_render_resource_grouping_identifiers;
+        std::vector<Vulkan_Backend::Identifier> m_swapchain_render_descriptor_set_identifiers;
 
         Vulkan_Backend::Identifier m_render_target_image_identifier;
+        Vulkan_Backend::Identifier m_beam_image_identifier;
+        Vulkan_Backend::Identifier m_output_image_identifier;
         Vulkan_Backend::Identifier m_camera_data_identifier;
+        Vulkan_Backend::Identifier m_camera_upload_buffer_identifier;
         Vulkan_Backend::Identifier m_object_buffer_identifier;
         Vulkan_Backend::Identifier m_voxel_buffer_identifier;
         Vulkan_Backend::Identifier m_hit_buffer_identifier;
-        Vulkan_Backend::Identifier m_staging_buffer_identifier;
+        Vulkan_Backend::Identifier m_bvh_buffer_identifier;
+        Vulkan_Backend::Identifier m_depth_buffer_identifier;
+        Vulkan_Backend::Identifier m_reprojection_buffer_identifier;
         std::vector<Vulkan_Backend::Identifier> m_swapchain_image_identifiers;
 
         std::shared_ptr<Vulkan_Backend::Vulkan_Graphics> m_vulkan_graphics_ptr;
         Window_Information m_window_information;
 
     private:
+        VkExtent2D Get_Beam_Extent();
+        static Vulkan_Backend::Swapchain_Wrapper::Present_Policy Get_Supported_Present_Policy(Vulkan_Backend::Swapchain_Wrapper::Present_Policy present_policy, double target_frame_rate);
+        size_t Get_Pixel_Count();
+        VkExtent2D Get_Render_Extent();
+        void Update_Render_Scale(double gpu_frame_time);
+        uint32_t Get_Frame_Timestamp_Count();
+        void Write_Frame_Timestamp(uint32_t command_buffer_index, uint32_t timestamp_index, VkPipelineStageFlagBits pipeline_stage);
+        void Resolve_Frame_Timestamps();
+        void Read_Traversal_Statistics(uint32_t frame_index);
+        void Create_Frame_Resources();
+        void Destroy_Frame_Resources();
+        void Create_Swapchain_Render_Descriptor_Sets();
+        void Destroy_Swapchain_Render_Descriptor_Sets();
+        Vulkan_Backend::Identifier Create_Render_Pipeline(Render_Pipeline_Configuration configuration);
+        std::string Get_Device_Tuning_Key();
+        bool Render_Pipeline_Configuration_Supported(Render_Pipeline_Configuration configuration);
+        void Load_Render_Pipeline_Configuration();
+        void Save_Render_Pipeline_Configuration();
+        double Time_Render_Pipeline(Render_Pipeline_Configuration configuration);
         void Record_Command_Buffers();
         void Recreate_Swapchain();
+        void Grow_Voxel_Buffer(size_t voxel_count, VkSemaphore render_timeline_semaphore);
 
     public:
-        Renderer(std::shared_ptr<Vulkan_Backend::Vulkan_Graphics> vulkan_graphics_ptr, Window_Information window_information);
+        Renderer(std::shared_ptr<Vulkan_Backend::Vulkan_Graphics> vulkan_graphics_ptr,
+                 Window_Information window_information,
+                 Vulkan_Backend::Swapchain_Wrapper::Present_Policy present_policy = Vulkan_Backend::Swapchain_Wrapper::Present_Policy::UNCAPPED,
+                 double target_frame_rate = 0.0);
         ~Renderer();
 
     public:
         std::shared_ptr<Camera> m_camera_ptr;
         std::shared_ptr<Object_Manager> m_object_manager_ptr;
+        std::shared_ptr<GPU_Octree_Builder> m_gpu_octree_builder_ptr;
 
     public:
         void Render_Frame();
         void Update_Objects();
         void Update_Voxels();
+        uint64_t Copy_Voxels_From_Buffer(Vulkan_Backend::Identifier source_buffer_identifier, size_t first_voxel_index, size_t voxel_count);
+        void Set_Beam_Prepass_Enabled(bool beam_prepass_enabled);
+        void Set_Temporal_Reprojection_Enabled(bool temporal_reprojection_enabled);
+        void Set_Dynamic_Resolution_Enabled(bool dynamic_resolution_enabled);
+        void Set_Target_Frame_Time(double target_frame_time);
+        void Set_Frames_In_Flight(uint32_t frames_in_flight);
+        void Set_Present_Policy(Vulkan_Backend::Swapchain_Wrapper::Present_Policy present_policy, double target_frame_rate = 0.0);
+        double Get_Render_Scale();
+        std::vector<Frame_Pass_Timing> Get_Frame_Pass_Timings();
+        void Tune_Render_Pipeline();
+        void Set_Debug_View(Debug_View debug_view);
+        void Set_Traversal_Statistics_Enabled(bool traversal_statistics_enabled);
+        Traversal_Statistics Get_Traversal_Statistics();
         void Start_Rendering();
     };
 } // namespace Cascade_Graphics
\ No newline at end of file
@@ -0,0 +1,775 @@
+#include "sdf_graph.hpp"
+
+#include "cascade_logging.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+
+namespace Cascade_Graphics
+{
+    SDF_Graph::SDF_Graph() : m_root_node_index(-1), m_lipschitz_bound(1.0), m_batch_scratch_size(0)
+    {
+    }
+
+    double SDF_Graph::Box_Distance(double x, double y, double z, double half_size_x, double half_size_y, double half_size_z)
+    {
+        double qx = std::abs(x) - half_size_x;
+        double qy = std::abs(y) - half_size_y;
+        double qz = std::abs(z) - half_size_z;
+
+        double outside_x = std::max(qx, 0.0);
+        double outside_y = std::max(qy, 0.0);
+        double outside_z = std::max(qz, 0.0);
+
+        return std::sqrt(outside_x * outside_x + outside_y * outside_y + outside_z * outside_z) + std::min(std::max(qx, std::max(qy, qz)), 0.0);
+    }
+
+    double SDF_Graph::Torus_Distance(double x, double y, double z, double major_radius, double minor_radius)
+    {
+        double qx = std::sqrt(x * x + z * z) - major_radius;
+
+        return std::sqrt(qx * qx + y * y) - minor_radius;
+    }
+
+    double SDF_Graph::Cylinder_Distance(double x, double y, double z, double radius, double half_height)
+    {
+        double dx = std::sqrt(x * x + z * z) - radius;
+        double dy = std::abs(y) - half_height;
+
+        double outside_x = std::max(dx, 0.0);
+        double outside_y = std::max(dy, 0.0);
+
+        return std::min(std::max(dx, dy), 0.0) + std::sqrt(outside_x * outside_x + outside_y * outside_y);
+    }
+
+    double SDF_Graph::Smooth_Minimum(double a, double b, double smoothing)
+    {
+        double h = std::min(std::max(0.5 + 0.5 * (b - a) / smoothing, 0.0), 1.0);
+
+        return b + (a - b) * h - smoothing * h * (1.0 - h);
+    }
+
+    double SDF_Graph::Hash_Lattice_Point(int32_t x, int32_t y, int32_t z, uint32_t seed)
+    {
+        uint32_t hash = seed ^ (static_cast<uint32_t>(x) * 73856093u) ^ (static_cast<uint32_t>(y) * 19349663u) ^ (static_cast<uint32_t>(z) * 83492791u);
+        hash = (hash ^ (hash >> 13)) * 1274126177u;
+        hash ^= hash >> 16;
+
+        return hash / 4294967295.0 * 2.0 - 1.0;
+    }
+
+    double SDF_Graph::Value_Noise(double x, double y, double z, uint32_t seed)
+    {
+        double cell_x = std::floor(x);
+        double cell_y = std::floor(y);
+        double cell_z = std::floor(z);
+
+        int32_t ix = static_cast<int32_t>(cell_x);
+        int32_t iy = static_cast<int32_t>(cell_y);
+        int32_t iz = static_cast<int32_t>(cell_z);
+
+        double fx = x - cell_x;
+        double fy = y - cell_y;
+        double fz = z - cell_z;
+
+        double ux = fx * fx * (3.0 - 2.0 * fx);
+        double uy = fy * fy * (3.0 - 2.0 * fy);
+        double uz = fz * fz * (3.0 - 2.0 * fz);
+
+        double c000 = Hash_Lattice_Point(ix, iy, iz, seed);
+        double c100 = Hash_Lattice_Point(ix + 1, iy, iz, seed);
+        double c010 = Hash_Lattice_Point(ix, iy + 1, iz, seed);
+        double c110 = Hash_Lattice_Point(ix + 1, iy + 1, iz, seed);
+        double c001 = Hash_Lattice_Point(ix, iy, iz + 1, seed);
+        double c101 = Hash_Lattice_Point(ix + 1, iy, iz + 1, seed);
+        double c011 = Hash_Lattice_Point(ix, iy + 1, iz + 1, seed);
+        double c111 = Hash_Lattice_Point(ix + 1, iy + 1, iz + 1, seed);
+
+        double c00 = c000 + (c100 - c000) * ux;
+        double c10 = c010 + (c110 - c010) * ux;
+        double c01 = c001 + (c101 - c001) * ux;
+        double c11 = c011 + (c111 - c011) * ux;
+
+        double c0 = c00 + (c10 - c00) * uy;
+        double c1 = c01 + (c11 - c01) * uy;
+
+        return c0 + (c1 - c0) * uz;
+    }
+
+    std::string SDF_Graph::Format_GLSL_Float(double value)
+    {
+        std::ostringstream stream;
+        stream << std::setprecision(9) << value;
+
+        std::string string = stream.str();
+        if (string.find_first_of(".e") == std::string::npos)
+        {
+            string += ".0";
+        }
+
+        return string;
+    }
+
+    void SDF_Graph::Validate_Input(uint32_t node_index)
+    {
+        if (node_index >= m_nodes.size())
+        {
+            LOG_ERROR << "Graphics: SDF node " << node_index << " does not exist";
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    uint32_t SDF_Graph::Add_Node(Node node)
+    {
+        // Every node gets its own scratch rows, a node is never evaluated inside itself so they can't be overwritten mid evaluation
+        node.batch_scratch_offset = m_batch_scratch_size;
+        if (node.type == TRANSLATE || node.type == ROTATE || node.type == SCALE)
+        {
+            m_batch_scratch_size += 3;
+        }
+        else if (node.type == UNION || node.type == INTERSECTION || node.type == SUBTRACTION || node.type == SMOOTH_UNION)
+        {
+            m_batch_scratch_size += 1;
+        }
+
+        m_nodes.push_back(node);
+
+        return static_cast<uint32_t>(m_nodes.size() - 1);
+    }
+
+    uint32_t SDF_Graph::Add_Sphere(double radius)
+    {
+        Node node = {};
+        node.type = SPHERE;
+        node.scalar_parameter_a = radius;
+
+        return Add_Node(node);
+    }
+
+    uint32_t SDF_Graph::Add_Box(Vector_3<double> half_size)
+    {
+        Node node = {};
+        node.type = BOX;
+        node.vector_parameter = half_size;
+
+        return Add_Node(node);
+    }
+
+    uint32_t SDF_Graph::Add_Torus(double major_radius, double minor_radius)
+    {
+        Node node = {};
+        node.type = TORUS;
+        node.scalar_parameter_a = major_radius;
+        node.scalar_parameter_b = minor_radius;
+
+        return Add_Node(node);
+    }
+
+    uint32_t SDF_Graph::Add_Cylinder(double radius, double half_height)
+    {
+        Node node = {};
+        node.type = CYLINDER;
+        node.scalar_parameter_a = radius;
+        node.scalar_parameter_b = half_height;
+
+        return Add_Node(node);
+    }
+
+    uint32_t SDF_Graph::Add_Plane(Vector_3<double> normal, double offset)
+    {
+        if (normal.Length() == 0.0)
+        {
+            LOG_ERROR << "Graphics: SDF plane normal cannot be zero";
+            exit(EXIT_FAILURE);
+        }
+
+        Node node = {};
+        node.type = PLANE;
+        node.vector_parameter = normal.Normalized();
+        node.scalar_parameter_a = offset;
+
+        return Add_Node(node);
+    }
+
+    uint32_t SDF_Graph::Add_Translate(uint32_t input, Vector_3<double> offset)
+    {
+        Validate_Input(input);
+
+        Node node = {};
+        node.type = TRANSLATE;
+        node.input_a = input;
+        node.vector_parameter = offset;
+
+        return Add_Node(node);
+    }
+
+    uint32_t SDF_Graph::Add_Rotate(uint32_t input, Vector_3<double> rotation)
+    {
+        Validate_Input(input);
+
+        double sin_yaw = sin(rotation.m_x);
+        double cos_yaw = cos(rotation.m_x);
+        double sin_pitch = sin(rotation.m_y);
+        double cos_pitch = cos(rotation.m_y);
+        double sin_roll = sin(rotation.m_z);
+        double cos_roll = cos(rotation.m_z);
+
+        // Same yaw, pitch, roll convention as object transforms, stored transposed to rotate sample points into the input's space
+        Node node = {};
+        node.type = ROTATE;
+        node.input_a = input;
+        node.vector_parameter = rotation;
+        node.rotation_matrix[0][0] = cos_pitch * cos_roll;
+        node.rotation_matrix[1][0] = sin_yaw * sin_pitch * cos_roll - cos_yaw * sin_roll;
+        node.rotation_matrix[2][0] = cos_yaw * sin_pitch * cos_roll + sin_yaw * sin_roll;
+        node.rotation_matrix[0][1] = cos_pitch * sin_roll;
+        node.rotation_matrix[1][1] = sin_yaw * sin_pitch * sin_roll + cos_yaw * cos_roll;
+        node.rotation_matrix[2][1] = cos_yaw * sin_pitch * sin_roll - sin_yaw * cos_roll;
+        node.rotation_matrix[0][2] = -sin_pitch;
+        node.rotation_matrix[1][2] = sin_yaw * cos_pitch;
+        node.rotation_matrix[2][2] = cos_yaw * cos_pitch;
+
+        return Add_Node(node);
+    }
+
+    uint32_t SDF_Graph::Add_Scale(uint32_t input, double scale)
+    {
+        Validate_Input(input);
+
+        if (scale <= 0.0)
+        {
+            LOG_ERROR << "Graphics: SDF scale must be positive";
+            exit(EXIT_FAILURE);
+        }
+
+        Node node = {};
+        node.type = SCALE;
+        node.input_a = input;
+        node.scalar_parameter_a = scale;
+
+        return Add_Node(node);
+    }
+
+    uint32_t SDF_Graph::Add_Union(uint32_t input_a, uint32_t input_b)
+    {
+        Validate_Input(input_a);
+        Validate_Input(input_b);
+
+        Node node = {};
+        node.type = UNION;
+        node.input_a = input_a;
+        node.input_b = input_b;
+
+        return Add_Node(node);
+    }
+
+    uint32_t SDF_Graph::Add_Intersection(uint32_t input_a, uint32_t input_b)
+    {
+        Validate_Input(input_a);
+        Validate_Input(input_b);
+
+        Node node = {};
+        node.type = INTERSECTION;
+        node.input_a = input_a;
+        node.input_b = input_b;
+
+        return Add_Node(node);
+    }
+
+    uint32_t SDF_Graph::Add_Subtraction(uint32_t input_a, uint32_t input_b)
+    {
+        Validate_Input(input_a);
+        Validate_Input(input_b);
+
+        Node node = {};
+        node.type = SUBTRACTION;
+        node.input_a = input_a;
+        node.input_b = input_b;
+
+        return Add_Node(node);
+    }
+
+    uint32_t SDF_Graph::Add_Smooth_Union(uint32_t input_a, uint32_t input_b, double smoothing)
+    {
+        Validate_Input(input_a);
+        Validate_Input(input_b);
+
+        if (smoothing <= 0.0)
+        {
+            LOG_ERROR << "Graphics: SDF smooth union smoothing must be positive";
+            exit(EXIT_FAILURE);
+        }
+
+        Node node = {};
+        node.type = SMOOTH_UNION;
+        node.input_a = input_a;
+        node.input_b = input_b;
+        node.scalar_parameter_a = smoothing;
+
+        return Add_Node(node);
+    }
+
+    uint32_t SDF_Graph::Add_Noise(uint32_t input, double amplitude, double frequency, uint32_t seed)
+    {
+        Validate_Input(input);
+
+        Node node = {};
+        node.type = NOISE;
+        node.input_a = input;
+        node.scalar_parameter_a = amplitude;
+        node.scalar_parameter_b = frequency;
+        node.seed = seed;
+
+        return Add_Node(node);
+    }
+
+    void SDF_Graph::Set_Root(uint32_t node_index)
+    {
+        Validate_Input(node_index);
+
+        m_root_node_index = node_index;
+        m_lipschitz_bound = Get_Node_Lipschitz_Bound(node_index);
+    }
+
+    double SDF_Graph::Evaluate_Node(uint32_t node_index, double x, double y, double z) const
+    {
+        const Node& node = m_nodes[node_index];
+
+        switch (node.type)
+        {
+            case SPHERE:
+                return std::sqrt(x * x + y * y + z * z) - node.scalar_parameter_a;
+            case BOX:
+                return Box_Distance(x, y, z, node.vector_parameter.m_x, node.vector_parameter.m_y, node.vector_parameter.m_z);
+            case TORUS:
+                return Torus_Distance(x, y, z, node.scalar_parameter_a, node.scalar_parameter_b);
+            case CYLINDER:
+                return Cylinder_Distance(x, y, z, node.scalar_parameter_a, node.scalar_parameter_b);
+            case PLANE:
+                return x * node.vector_parameter.m_x + y * node.vector_parameter.m_y + z * node.vector_parameter.m_z - node.scalar_parameter_a;
+            case TRANSLATE:
+                return Evaluate_Node(node.input_a, x - node.vector_parameter.m_x, y - node.vector_parameter.m_y, z - node.vector_parameter.m_z);
+            case ROTATE:
+                return Evaluate_Node(node.input_a, node.rotation_matrix[0][0] * x + node.rotation_matrix[0][1] * y + node.rotation_matrix[0][2] * z,
+                                     node.rotation_matrix[1][0] * x + node.rotation_matrix[1][1] * y + node.rotation_matrix[1][2] * z,
+                                     node.rotation_matrix[2][0] * x + node.rotation_matrix[2][1] * y + node.rotation_matrix[2][2] * z);
+            case SCALE:
+                return Evaluate_Node(node.input_a, x / node.scalar_parameter_a, y / node.scalar_parameter_a, z / node.scalar_parameter_a) * node.scalar_parameter_a;
+            case UNION:
+                return std::min(Evaluate_Node(node.input_a, x, y, z), Evaluate_Node(node.input_b, x, y, z));
+            case INTERSECTION:
+                return std::max(Evaluate_Node(node.input_a, x, y, z), Evaluate_Node(node.input_b, x, y, z));
+            case SUBTRACTION:
+                return std::max(Evaluate_Node(node.input_a, x, y, z), -Evaluate_Node(node.input_b, x, y, z));
+            case SMOOTH_UNION:
+                return Smooth_Minimum(Evaluate_Node(node.input_a, x, y, z), Evaluate_Node(node.input_b, x, y, z), node.scalar_parameter_a);
+            case NOISE:
+                return Evaluate_Node(node.input_a, x, y, z) + node.scalar_parameter_a * Value_Noise(x * node.scalar_parameter_b, y * node.scalar_parameter_b, z * node.scalar_parameter_b, node.seed);
+        }
+
+        return 0.0;
+    }
+
+    void SDF_Graph::Evaluate_Node_Batch(uint32_t node_index, const double* x, const double* y, const double* z, double* distances, size_t count, double* scratch_ptr) const
+    {
+        const Node& node = m_nodes[node_index];
+
+        // Each node runs one flat loop over the whole batch so the compiler can vectorize it
+        switch (node.type)
+        {
+            case SPHERE:
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    distances[i] = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]) - node.scalar_parameter_a;
+                }
+                return;
+            }
+            case BOX:
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    distances[i] = Box_Distance(x[i], y[i], z[i], node.vector_parameter.m_x, node.vector_parameter.m_y, node.vector_parameter.m_z);
+                }
+                return;
+            }
+            case TORUS:
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    distances[i] = Torus_Distance(x[i], y[i], z[i], node.scalar_parameter_a, node.scalar_parameter_b);
+                }
+                return;
+            }
+            case CYLINDER:
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    distances[i] = Cylinder_Distance(x[i], y[i], z[i], node.scalar_parameter_a, node.scalar_parameter_b);
+                }
+                return;
+            }
+            case PLANE:
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    distances[i] = x[i] * node.vector_parameter.m_x + y[i] * node.vector_parameter.m_y + z[i] * node.vector_parameter.m_z - node.scalar_parameter_a;
+                }
+                return;
+            }
+            case TRANSLATE:
+            case ROTATE:
+            case SCALE:
+            {
+                double* transformed_x = scratch_ptr + node.batch_scratch_offset * count;
+                double* transformed_y = transformed_x + count;
+                double* transformed_z = transformed_y + count;
+
+                if (node.type == TRANSLATE)
+                {
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        transformed_x[i] = x[i] - node.vector_parameter.m_x;
+                        transformed_y[i] = y[i] - node.vector_parameter.m_y;
+                        transformed_z[i] = z[i] - node.vector_parameter.m_z;
+                    }
+                }
+                else if (node.type == ROTATE)
+                {
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        transformed_x[i] = node.rotation_matrix[0][0] * x[i] + node.rotation_matrix[0][1] * y[i] + node.rotation_matrix[0][2] * z[i];
+                        transformed_y[i] = node.rotation_matrix[1][0] * x[i] + node.rotation_matrix[1][1] * y[i] + node.rotation_matrix[1][2] * z[i];
+                        transformed_z[i] = node.rotation_matrix[2][0] * x[i] + node.rotation_matrix[2][1] * y[i] + node.rotation_matrix[2][2] * z[i];
+                    }
+                }
+                else
+                {
+                    double inverse_scale = 1.0 / node.scalar_parameter_a;
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        transformed_x[i] = x[i] * inverse_scale;
+                        transformed_y[i] = y[i] * inverse_scale;
+                        transformed_z[i] = z[i] * inverse_scale;
+                    }
+                }
+
+                Evaluate_Node_Batch(node.input_a, transformed_x, transformed_y, transformed_z, distances, count, scratch_ptr);
+
+                if (node.type == SCALE)
+                {
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        distances[i] *= node.scalar_parameter_a;
+                    }
+                }
+                return;
+            }
+            case UNION:
+            case INTERSECTION:
+            case SUBTRACTION:
+            case SMOOTH_UNION:
+            {
+                double* distances_b = scratch_ptr + node.batch_scratch_offset * count;
+
+                Evaluate_Node_Batch(node.input_a, x, y, z, distances, count, scratch_ptr);
+                Evaluate_Node_Batch(node.input_b, x, y, z, distances_b, count, scratch_ptr);
+
+                if (node.type == UNION)
+                {
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        distances[i] = std::min(distances[i], distances_b[i]);
+                    }
+                }
+                else if (node.type == INTERSECTION)
+                {
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        distances[i] = std::max(distances[i], distances_b[i]);
+                    }
+                }
+                else if (node.type == SUBTRACTION)
+                {
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        distances[i] = std::max(distances[i], -distances_b[i]);
+                    }
+                }
+                else
+                {
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        distances[i] = Smooth_Minimum(distances[i], distances_b[i], node.scalar_parameter_a);
+                    }
+                }
+                return;
+            }
+            case NOISE:
+            {
+                Evaluate_Node_Batch(node.input_a, x, y, z, distances, count, scratch_ptr);
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    distances[i] += node.scalar_parameter_a * Value_Noise(x[i] * node.scalar_parameter_b, y[i] * node.scalar_parameter_b, z[i] * node.scalar_parameter_b, node.seed);
+                }
+                return;
+            }
+        }
+    }
+
+    double SDF_Graph::Get_Node_Lipschitz_Bound(uint32_t node_index) const
+    {
+        const Node& node = m_nodes[node_index];
+
+        switch (node.type)
+        {
+            case SPHERE:
+            case BOX:
+            case TORUS:
+            case CYLINDER:
+            case PLANE:
+                return 1.0;
+            case TRANSLATE:
+            case ROTATE:
+            case SCALE:
+                return Get_Node_Lipschitz_Bound(node.input_a);
+            case UNION:
+            case INTERSECTION:
+            case SUBTRACTION:
+            case SMOOTH_UNION:
+                return std::max(Get_Node_Lipschitz_Bound(node.input_a), Get_Node_Lipschitz_Bound(node.input_b));
+            case NOISE:
+                // Lattice values differ by at most 2 and the fade curve's slope peaks at 1.5, on each of the three axes
+                return Get_Node_Lipschitz_Bound(node.input_a) + std::abs(node.scalar_parameter_a) * std::abs(node.scalar_parameter_b) * 3.0 * std::sqrt(3.0);
+        }
+
+        return 1.0;
+    }
+
+    std::string SDF_Graph::Emit_Node_GLSL(uint32_t node_index, std::string position_variable, std::string function_name, std::string& source, uint32_t& variable_count) const
+    {
+        const Node& node = m_nodes[node_index];
+
+        std::string expression;
+        switch (node.type)
+        {
+            case SPHERE:
+                expression = "length(" + position_variable + ") - " + Format_GLSL_Float(node.scalar_parameter_a);
+                break;
+            case BOX:
+                expression = function_name + "_Box(" + position_variable + ", vec3(" + Format_GLSL_Float(node.vector_parameter.m_x) + ", " + Format_GLSL_Float(node.vector_parameter.m_y) + ", " + Format_GLSL_Float(node.vector_parameter.m_z) + "))";
+                break;
+            case TORUS:
+                expression = function_name + "_Torus(" + position_variable + ", " + Format_GLSL_Float(node.scalar_parameter_a) + ", " + Format_GLSL_Float(node.scalar_parameter_b) + ")";
+                break;
+            case CYLINDER:
+                expression = function_name + "_Cylinder(" + position_variable + ", " + Format_GLSL_Float(node.scalar_parameter_a) + ", " + Format_GLSL_Float(node.scalar_parameter_b) + ")";
+                break;
+            case PLANE:
+                expression = "dot(" + position_variable + ", vec3(" + Format_GLSL_Float(node.vector_parameter.m_x) + ", " + Format_GLSL_Float(node.vector_parameter.m_y) + ", " + Format_GLSL_Float(node.vector_parameter.m_z) + ")) - "
+                             + Format_GLSL_Float(node.scalar_parameter_a);
+                break;
+            case TRANSLATE:
+            case ROTATE:
+            case SCALE:
+            {
+                std::string transformed_position_variable = "position_" + std::to_string(variable_count++);
+
+                std::string transformed_position;
+                if (node.type == TRANSLATE)
+                {
+                    transformed_position = position_variable + " - vec3(" + Format_GLSL_Float(node.vector_parameter.m_x) + ", " + Format_GLSL_Float(node.vector_parameter.m_y) + ", " + Format_GLSL_Float(node.vector_parameter.m_z) + ")";
+                }
+                else if (node.type == ROTATE)
+                {
+                    // Filling a column major mat3 row by row gives the transpose, so the position is multiplied from the left
+                    transformed_position = position_variable + " * mat3(";
+                    for (uint32_t row = 0; row < 3; row++)
+                    {
+                        for (uint32_t column = 0; column < 3; column++)
+                        {
+                            transformed_position += Format_GLSL_Float(node.rotation_matrix[row][column]) + (row == 2 && column == 2 ? ")" : ", ");
+                        }
+                    }
+                }
+                else
+                {
+                    transformed_position = position_variable + " / " + Format_GLSL_Float(node.scalar_parameter_a);
+                }
+                source += "    vec3 " + transformed_position_variable + " = " + transformed_position + ";\n";
+
+                std::string input_variable = Emit_Node_GLSL(node.input_a, transformed_position_variable, function_name, source, variable_count);
+                if (node.type != SCALE)
+                {
+                    return input_variable;
+                }
+
+                expression = input_variable + " * " + Format_GLSL_Float(node.scalar_parameter_a);
+                break;
+            }
+            case UNION:
+            case INTERSECTION:
+            case SUBTRACTION:
+            case SMOOTH_UNION:
+            {
+                std::string input_a_variable = Emit_Node_GLSL(node.input_a, position_variable, function_name, source, variable_count);
+                std::string input_b_variable = Emit_Node_GLSL(node.input_b, position_variable, function_name, source, variable_count);
+
+                if (node.type == UNION)
+                {
+                    expression = "min(" + input_a_variable + ", " + input_b_variable + ")";
+                }
+                else if (node.type == INTERSECTION)
+                {
+                    expression = "max(" + input_a_variable + ", " + input_b_variable + ")";
+                }
+                else if (node.type == SUBTRACTION)
+                {
+                    expression = "max(" + input_a_variable + ", -" + input_b_variable + ")";
+                }
+                else
+                {
+                    expression = function_name + "_Smooth_Minimum(" + input_a_variable + ", " + input_b_variable + ", " + Format_GLSL_Float(node.scalar_parameter_a) + ")";
+                }
+                break;
+            }
+            case NOISE:
+            {
+                std::string input_variable = Emit_Node_GLSL(node.input_a, position_variable, function_name, source, variable_count);
+                expression = input_variable + " + " + Format_GLSL_Float(node.scalar_parameter_a) + " * " + function_name + "_Value_Noise(" + position_variable + " * " + Format_GLSL_Float(node.scalar_parameter_b) + ", "
+                             + std::to_string(node.seed) + "u)";
+                break;
+            }
+        }
+
+        std::string distance_variable = "distance_" + std::to_string(variable_count++);
+        source += "    float " + distance_variable + " = " + expression + ";\n";
+
+        return distance_variable;
+    }
+
+    double SDF_Graph::Evaluate(Vector_3<double> position) const
+    {
+        if (m_root_node_index == (uint32_t)-1)
+        {
+            LOG_ERROR << "Graphics: Cannot evaluate an SDF graph without a root node";
+            exit(EXIT_FAILURE);
+        }
+
+        return Evaluate_Node(m_root_node_index, position.m_x, position.m_y, position.m_z);
+    }
+
+    void SDF_Graph::Evaluate_Batch(const std::vector<Vector_3<double>>& positions, std::vector<double>& distances, std::vector<double>& scratch) const
+    {
+        if (m_root_node_index == (uint32_t)-1)
+        {
+            LOG_ERROR << "Graphics: Cannot evaluate an SDF graph without a root node";
+            exit(EXIT_FAILURE);
+        }
+
+        distances.resize(positions.size());
+
+        // The caller keeps the scratch space between calls, it holds the batch coordinates followed by every node's rows
+        size_t scratch_size = (3 + m_batch_scratch_size) * BATCH_SIZE;
+        if (scratch.size() < scratch_size)
+        {
+            scratch.resize(scratch_size);
+        }
+
+        double* batch_x = scratch.data();
+        double* batch_y = batch_x + BATCH_SIZE;
+        double* batch_z = batch_y + BATCH_SIZE;
+        double* node_scratch_ptr = batch_z + BATCH_SIZE;
+
+        for (size_t batch_start = 0; batch_start < positions.size(); batch_start += BATCH_SIZE)
+        {
+            size_t batch_count = std::min(BATCH_SIZE, positions.size() - batch_start);
+
+            for (size_t i = 0; i < batch_count; i++)
+            {
+                batch_x[i] = positions[batch_start + i].m_x;
+                batch_y[i] = positions[batch_start + i].m_y;
+                batch_z[i] = positions[batch_start + i].m_z;
+            }
+
+            Evaluate_Node_Batch(m_root_node_index, batch_x, batch_y, batch_z, distances.data() + batch_start, batch_count, node_scratch_ptr);
+        }
+    }
+
+    void SDF_Graph::Get_Bounds(Vector_3<double> box_center, double box_half_size, double& min_distance, double& max_distance) const
+    {
+        // The field can't change faster than its Lipschitz bound, so the corners are the furthest it can drift from the center
+        double center_distance = Evaluate(box_center);
+        double max_change = m_lipschitz_bound * box_half_size * std::sqrt(3.0);
+
+        min_distance = center_distance - max_change;
+        max_distance = center_distance + max_change;
+    }
+
+    std::string SDF_Graph::Emit_GLSL(std::string function_name) const
+    {
+        if (m_root_node_index == (uint32_t)-1)
+        {
+            LOG_ERROR << "Graphics: Cannot emit an SDF graph without a root node";
+            exit(EXIT_FAILURE);
+        }
+
+        std::string source;
+        source += "float " + function_name + "_Box(vec3 position, vec3 half_size)\n{\n";
+        source += "    vec3 q = abs(position) - half_size;\n";
+        source += "    return length(max(q, 0.0)) + min(max(q.x, max(q.y, q.z)), 0.0);\n}\n\n";
+
+        source += "float " + function_name + "_Torus(vec3 position, float major_radius, float minor_radius)\n{\n";
+        source += "    return length(vec2(length(position.xz) - major_radius, position.y)) - minor_radius;\n}\n\n";
+
+        source += "float " + function_name + "_Cylinder(vec3 position, float radius, float half_height)\n{\n";
+        source += "    vec2 d = vec2(length(position.xz) - radius, abs(position.y) - half_height);\n";
+        source += "    return min(max(d.x, d.y), 0.0) + length(max(d, 0.0));\n}\n\n";
+
+        source += "float " + function_name + "_Smooth_Minimum(float a, float b, float smoothing)\n{\n";
+        source += "    float h = clamp(0.5 + 0.5 * (b - a) / smoothing, 0.0, 1.0);\n";
+        source += "    return mix(b, a, h) - smoothing * h * (1.0 - h);\n}\n\n";
+
+        source += "float " + function_name + "_Hash_Lattice_Point(ivec3 cell, uint seed)\n{\n";
+        source += "    uint hash = seed ^ (uint(cell.x) * 73856093u) ^ (uint(cell.y) * 19349663u) ^ (uint(cell.z) * 83492791u);\n";
+        source += "    hash = (hash ^ (hash >> 13)) * 1274126177u;\n";
+        source += "    hash ^= hash >> 16;\n";
+        source += "    return float(hash) / 4294967295.0 * 2.0 - 1.0;\n}\n\n";
+
+        source += "float " + function_name + "_Value_Noise(vec3 position, uint seed)\n{\n";
+        source += "    vec3 cell = floor(position);\n";
+        source += "    ivec3 i = ivec3(cell);\n";
+        source += "    vec3 f = position - cell;\n";
+        source += "    vec3 u = f * f * (3.0 - 2.0 * f);\n";
+        source += "    float c00 = mix(" + function_name + "_Hash_Lattice_Point(i, seed), " + function_name + "_Hash_Lattice_Point(i + ivec3(1, 0, 0), seed), u.x);\n";
+        source += "    float c10 = mix(" + function_name + "_Hash_Lattice_Point(i + ivec3(0, 1, 0), seed), " + function_name + "_Hash_Lattice_Point(i + ivec3(1, 1, 0), seed), u.x);\n";
+        source += "    float c01 = mix(" + function_name + "_Hash_Lattice_Point(i + ivec3(0, 0, 1), seed), " + function_name + "_Hash_Lattice_Point(i + ivec3(1, 0, 1), seed), u.x);\n";
+        source += "    float c11 = mix(" + function_name + "_Hash_Lattice_Point(i + ivec3(0, 1, 1), seed), " + function_name + "_Hash_Lattice_Point(i + ivec3(1, 1, 1), seed), u.x);\n";
+        source += "    return mix(mix(c00, c10, u.y), mix(c01, c11, u.y), u.z);\n}\n\n";
+
+        std::string body;
+        uint32_t variable_count = 0;
+        std::string result_variable = Emit_Node_GLSL(m_root_node_index, "position", function_name, body, variable_count);
+
+        source += "float " + function_name + "(vec3 position)\n{\n" + body + "    return " + result_variable + ";\n}\n";
+
+        return source;
+    }
+
+    std::function<double(Vector_3<double>)> SDF_Graph::Get_Volume_Function() const
+    {
+        SDF_Graph graph = *this;
+
+        return [graph](Vector_3<double> position) { return graph.Evaluate(position); };
+    }
+
+    std::function<void(Vector_3<double>, double, double&, double&)> SDF_Graph::Get_Volume_Bounds_Function() const
+    {
+        SDF_Graph graph = *this;
+
+        return [graph](Vector_3<double> box_center, double box_half_size, double& min_distance, double& max_distance) { graph.Get_Bounds(box_center, box_half_size, min_distance, max_distance); };
+    }
+} // namespace Cascade_Graphics
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Data_Types/vector_3.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace Cascade_Graphics
+{
+    class SDF_Graph
+    {
+    public:
+        enum Node_Type
+        {
+            SPHERE,
+            BOX,
+            TORUS,
+            CYLINDER,
+            PLANE,
+            TRANSLATE,
+            ROTATE,
+            SCALE,
+            UNION,
+            INTERSECTION,
+            SUBTRACTION,
+            SMOOTH_UNION,
+            NOISE
+        };
+
+    private:
+        struct Node
+        {
+            Node_Type type;
+
+            uint32_t input_a;
+            uint32_t input_b;
+
+            Vector_3<double> vector_parameter;
+            double scalar_parameter_a;
+            double scalar_parameter_b;
+            uint32_t seed;
+
+            double rotation_matrix[3][3];
+
+            size_t batch_scratch_offset;
+        };
+
+    private:
+        static const size_t BATCH_SIZE = 256;
+
+        std::vector<Node> m_nodes;
+        uint32_t m_root_node_index;
+        double m_lipschitz_bound;
+        size_t m_batch_scratch_size;
+
+    private:
+        static double Box_Distance(double x, double y, double z, double half_size_x, double half_size_y, double half_size_z);
+        static double Torus_Distance(double x, double y, double z, double major_radius, double minor_radius);
+        static double Cylinder_Distance(double x, double y, double z, double radius, double half_height);
+        static double Smooth_Minimum(double a, double b, double smoothing);
+        static double Hash_Lattice_Point(int32_t x, int32_t y, int32_t z, uint32_t seed);
+        static double Value_Noise(double x, double y, double z, uint32_t seed);
+        static std::string Format_GLSL_Float(double value);
+
+        void Validate_Input(uint32_t node_index);
+        uint32_t Add_Node(Node node);
+
+        double Evaluate_Node(uint32_t node_index, double x, double y, double z) const;
+        void Evaluate_Node_Batch(uint32_t node_index, const double* x, const double* y, const double* z, double* distances, size_t count, double* scratch_ptr) const;
+        double Get_Node_Lipschitz_Bound(uint32_t node_index) const;
+        std::string Emit_Node_GLSL(uint32_t node_index, std::string position_variable, std::string function_name, std::string& source, uint32_t& variable_count) const;
+
+    public:
+        SDF_Graph();
+
+    public:
+        uint32_t Add_Sphere(double radius);
+        uint32_t Add_Box(Vector_3<double> half_size);
+        uint32_t Add_Torus(double major_radius, double minor_radius);
+        uint32_t Add_Cylinder(double radius, double half_height);
+        uint32_t Add_Plane(Vector_3<double> normal, double offset);
+
+        uint32_t Add_Translate(uint32_t input, Vector_3<double> offset);
+        uint32_t Add_Rotate(uint32_t input, Vector_3<double> rotation);
+        uint32_t Add_Scale(uint32_t input, double scale);
+
+        uint32_t Add_Union(uint32_t input_a, uint32_t input_b);
+        uint32_t Add_Intersection(uint32_t input_a, uint32_t input_b);
+        uint32_t Add_Subtraction(uint32_t input_a, uint32_t input_b);
+        uint32_t Add_Smooth_Union(uint32_t input_a, uint32_t input_b, double smoothing);
+        uint32_t Add_Noise(uint32_t input, double amplitude, double frequency, uint32_t seed);
+
+        void Set_Root(uint32_t node_index);
+
+        double Evaluate(Vector_3<double> position) const;
+        void Evaluate_Batch(const std::vector<Vector_3<double>>& positions, std::vector<double>& distances, std::vector<double>& scratch) const;
+        void Get_Bounds(Vector_3<double> box_center, double box_half_size, double& min_distance, double& max_distance) const;
+        std::string Emit_GLSL(std::string function_name) const;
+
+        std::function<double(Vector_3<double>)> Get_Volume_Function() const;
+        std::function<void(Vector_3<double>, double, double&, double&)> Get_Volume_Bounds_Function() const;
+    };
+} // namespace Cascade_Graphics
@@ -1,7 +1,9 @@
 #include "cascade_engine.hpp"
 
 #include <cmath>
+#include <cstdlib>
 #include <memory>
+#include <string>
 
 std::shared_ptr<Cascade_Core::Window> main_window_ptr;
 
@@ -52,11 +54,24 @@ Cascade_Graphics::Vector_3<double> Color_Sample_Function_Moon(Cascade_Graphics::
     return {0.75, 0.75, 0.75};
 }
 
-int main()
+int main(int argc, char** argv)
 {
     Cascade_Core::Application application({"Test Cascade Application", 0, 5});
     main_window_ptr = application.Create_Window("Main Window", 1920, 1080);
 
+    // Builds a test volume with both octree builders and exits with whether they agree
+    if (argc > 1 && std::string(argv[1]) == "--validate-gpu-octree-builder")
+    {
+        Cascade_Graphics::SDF_Graph sdf_graph;
+        uint32_t sphere_node = sdf_graph.Add_Sphere(1.5);
+        uint32_t box_node = sdf_graph.Add_Translate(sdf_graph.Add_Box({0.5, 0.5, 0.5}), {1.2, 0.0, 0.0});
+        sdf_graph.Set_Root(sdf_graph.Add_Subtraction(sphere_node, box_node));
+
+        bool validation_passed = main_window_ptr->Get_Renderer()->m_gpu_octree_builder_ptr->Validate_Against_CPU_Builder(7, Cascade_Graphics::Vector_3<double>(0, 0, 0), 2.0, sdf_graph, 1 << 20);
+
+        return validation_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     main_window_ptr->Get_Renderer()->m_object_manager_ptr->Create_Object_From_Volume_Function("planet", 9, Cascade_Graphics::Vector_3<double>(0, 0, 0), 2.0, Volume_Sample_Function, Color_Sample_Function);
     main_window_ptr->Get_Renderer()->m_object_manager_ptr->Create_Object_From_Volume_Function("moon", 8, Cascade_Graphics::Vector_3<double>(0, 0, 0), 2.0, Volume_Sample_Function, Color_Sample_Function_Moon);
     main_window_ptr->Get_Renderer()->Update_Voxels();